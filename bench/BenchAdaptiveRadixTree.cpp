@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AdaptiveRadixTree.h"
+#include "BinarySearchTree.h"
+#include "HashTable.h"
+#include "benchmark/benchmark.h"
+
+using namespace std;
+
+// Path-like keys, e.g. "tenant/0042/user/0001337/profile", in random
+// order: long shared beginnings, as real string keys tend to have.
+static vector<string> makeKeys(size_t n)
+{
+	static const char* kinds[] = { "profile", "settings", "inbox", "photos" };
+	mt19937 gen(42);
+	vector<string> keys;
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		string user = to_string(i / 4);
+		string tenant = to_string(i % 97);
+
+		keys.push_back("tenant/" + string(4 - min<size_t>(4, tenant.size()), '0') + tenant +
+				"/user/" + string(7 - min<size_t>(7, user.size()), '0') + user + "/" + kinds[i % 4]);
+	}
+
+	shuffle(keys.begin(), keys.end(), gen);
+
+	return keys;
+}
+
+// 1024 keys to look up, all present.
+static vector<string> makeLookups(const vector<string>& keys)
+{
+	mt19937 gen(7);
+	uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+	vector<string> v;
+
+	for (int i = 0; i < 1024; ++i)
+	{
+		v.push_back(keys[pick(gen)]);
+	}
+
+	return v;
+}
+
+static void sizes(benchmark::internal::Benchmark* b)
+{
+	b->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18);
+}
+
+typedef HashTable<string, int, hash<string>> StringTable;
+
+static void BM_ARTFind(benchmark::State& state)
+{
+	vector<string> keys = makeKeys(state.range(0));
+	vector<string> lookups = makeLookups(keys);
+	AdaptiveRadixTree<int> t;
+
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		t.put(keys[i], static_cast<int>(i));
+	}
+
+	for (auto _ : state)
+	{
+		int sum = 0;
+
+		for (const auto& key : lookups)
+		{
+			sum += *t.find(key);
+		}
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetItemsProcessed(state.iterations() * lookups.size());
+	state.counters["bytes_per_key"] = static_cast<double>(t.bytes()) / keys.size();
+}
+BENCHMARK(BM_ARTFind)->Apply(sizes);
+
+static void BM_BSTFindString(benchmark::State& state)
+{
+	vector<string> keys = makeKeys(state.range(0));
+	vector<string> lookups = makeLookups(keys);
+	BinarySearchTree<string> t(keys);
+
+	for (auto _ : state)
+	{
+		int hits = 0;
+
+		for (const auto& key : lookups)
+		{
+			hits += t.contains(key);
+		}
+
+		benchmark::DoNotOptimize(hits);
+	}
+
+	state.SetItemsProcessed(state.iterations() * lookups.size());
+	state.counters["bytes_per_key"] = sizeof(Node<string>);
+}
+BENCHMARK(BM_BSTFindString)->Apply(sizes);
+
+static void BM_HashTableFindString(benchmark::State& state)
+{
+	vector<string> keys = makeKeys(state.range(0));
+	vector<string> lookups = makeLookups(keys);
+	StringTable t(keys.size());
+
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		t.put(keys[i], static_cast<int>(i));
+	}
+
+	for (auto _ : state)
+	{
+		int sum = 0;
+
+		for (const auto& key : lookups)
+		{
+			sum += *t.find(key);
+		}
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	// Entries plus one vector per bucket; spare capacity not counted.
+	state.SetItemsProcessed(state.iterations() * lookups.size());
+	state.counters["bytes_per_key"] = sizeof(pair<string, int>) +
+			static_cast<double>(t.bucketCount() * sizeof(vector<pair<string, int>>)) / keys.size();
+}
+BENCHMARK(BM_HashTableFindString)->Apply(sizes);
+
+static void BM_ARTPut(benchmark::State& state)
+{
+	vector<string> keys = makeKeys(state.range(0));
+
+	for (auto _ : state)
+	{
+		AdaptiveRadixTree<int> t;
+
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			t.put(keys[i], static_cast<int>(i));
+		}
+
+		benchmark::DoNotOptimize(t.size());
+	}
+
+	state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_ARTPut)->Apply(sizes);
+
+static void BM_BSTInsertString(benchmark::State& state)
+{
+	vector<string> keys = makeKeys(state.range(0));
+
+	for (auto _ : state)
+	{
+		BinarySearchTree<string> t(keys);
+		benchmark::DoNotOptimize(t);
+	}
+
+	state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_BSTInsertString)->Apply(sizes);
+
+// Every key of one tenant: about n / 97 results.
+static void BM_ARTPrefixScan(benchmark::State& state)
+{
+	vector<string> keys = makeKeys(state.range(0));
+	AdaptiveRadixTree<int> t;
+
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		t.put(keys[i], static_cast<int>(i));
+	}
+
+	for (auto _ : state)
+	{
+		size_t count = 0;
+
+		t.forEachPrefix("tenant/0042/", [&count](const string&, int) { ++count; });
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK(BM_ARTPrefixScan)->Apply(sizes);
+
+static void BM_BSTPrefixScan(benchmark::State& state)
+{
+	vector<string> keys = makeKeys(state.range(0));
+	BinarySearchTree<string> t(keys);
+
+	for (auto _ : state)
+	{
+		// '0' follows '/': the keys starting "tenant/0042/" are below.
+		benchmark::DoNotOptimize(t.countRange("tenant/0042/", "tenant/00420"));
+	}
+}
+BENCHMARK(BM_BSTPrefixScan)->Apply(sizes);
+
+BENCHMARK_MAIN();
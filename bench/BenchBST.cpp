@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "BinarySearchTree.h"
+#include "benchmark/benchmark.h"
+
+using namespace std;
+
+enum Order { Sorted, Random };
+
+static vector<int> makeKeys(size_t n, int order)
+{
+	vector<int> keys(n);
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		keys[i] = static_cast<int>(i * 2);
+	}
+
+	if (order == Random)
+	{
+		shuffle(keys.begin(), keys.end(), mt19937(42));
+	}
+
+	return keys;
+}
+
+// Arguments: number of keys, insertion order. Sorted input degenerates
+// into a list, so it is kept small.
+static void sizes(benchmark::internal::Benchmark* b)
+{
+	for (int n : { 1 << 8, 1 << 10, 1 << 12 })
+	{
+		b->Args({ n, Sorted });
+	}
+
+	for (int n : { 1 << 10, 1 << 14, 1 << 18 })
+	{
+		b->Args({ n, Random });
+	}
+}
+
+static void BM_BSTInsert(benchmark::State& state)
+{
+	vector<int> keys = makeKeys(state.range(0), static_cast<int>(state.range(1)));
+
+	for (auto _ : state)
+	{
+		BinarySearchTree<int> t(keys);
+		benchmark::DoNotOptimize(t);
+	}
+
+	state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_BSTInsert)->Apply(sizes);
+
+static void BM_BSTSearchHit(benchmark::State& state)
+{
+	vector<int> keys = makeKeys(state.range(0), static_cast<int>(state.range(1)));
+	BinarySearchTree<int> t(keys);
+
+	shuffle(keys.begin(), keys.end(), mt19937(7));
+
+	for (auto _ : state)
+	{
+		for (const auto& k : keys)
+		{
+			benchmark::DoNotOptimize(t.contains(k));
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_BSTSearchHit)->Apply(sizes);
+
+static void BM_BSTSearchMiss(benchmark::State& state)
+{
+	vector<int> keys = makeKeys(state.range(0), static_cast<int>(state.range(1)));
+	BinarySearchTree<int> t(keys);
+
+	// All keys are even.
+	for (auto& k : keys)
+	{
+		k += 1;
+	}
+
+	for (auto _ : state)
+	{
+		for (const auto& k : keys)
+		{
+			benchmark::DoNotOptimize(t.contains(k));
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_BSTSearchMiss)->Apply(sizes);
+
+static void BM_BSTSerialize(benchmark::State& state)
+{
+	vector<int> keys = makeKeys(state.range(0), static_cast<int>(state.range(1)));
+	BinarySearchTree<int> t(keys);
+
+	for (auto _ : state)
+	{
+		stringstream ss;
+		t.serialize(ss);
+		benchmark::DoNotOptimize(ss);
+	}
+
+	state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_BSTSerialize)->Apply(sizes);
+
+static void BM_BSTDeserialize(benchmark::State& state)
+{
+	vector<int> keys = makeKeys(state.range(0), static_cast<int>(state.range(1)));
+	BinarySearchTree<int> t(keys);
+
+	stringstream ss;
+	t.serialize(ss);
+	string s = ss.str();
+
+	for (auto _ : state)
+	{
+		istringstream in(s);
+		BinarySearchTree<int> u;
+		u.deserialize(in);
+		benchmark::DoNotOptimize(u);
+	}
+
+	state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_BSTDeserialize)->Apply(sizes);
+
+// The keys in a window of 1% of the key space: filtering inorder(),
+// then walking range().
+static void BM_BSTRangeByInorder(benchmark::State& state)
+{
+	vector<int> keys = makeKeys(state.range(0), static_cast<int>(state.range(1)));
+	BinarySearchTree<int> t(keys);
+	int lo = static_cast<int>(keys.size());
+	int hi = lo + static_cast<int>(keys.size() / 50);
+	size_t count = 0;
+
+	for (auto _ : state)
+	{
+		vector<int> v = t.inorder();
+		count = count_if(v.begin(), v.end(), [lo, hi](int k) { return lo <= k && k <= hi; });
+		benchmark::DoNotOptimize(count);
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BSTRangeByInorder)->Apply(sizes);
+
+static void BM_BSTRange(benchmark::State& state)
+{
+	vector<int> keys = makeKeys(state.range(0), static_cast<int>(state.range(1)));
+	BinarySearchTree<int> t(keys);
+	int lo = static_cast<int>(keys.size());
+	int hi = lo + static_cast<int>(keys.size() / 50);
+	size_t count = 0;
+
+	for (auto _ : state)
+	{
+		count = 0;
+
+		for (int k : t.range(lo, hi))
+		{
+			benchmark::DoNotOptimize(k);
+			++count;
+		}
+
+		benchmark::DoNotOptimize(count);
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BSTRange)->Apply(sizes);
+
+// Two trees of n keys each, even and odd, merged into one: inserting
+// the keys of both into a new tree, then the linear merge.
+static void BM_BSTMergeByInsert(benchmark::State& state)
+{
+	vector<int> keys = makeKeys(state.range(0), static_cast<int>(state.range(1)));
+	vector<int> odd(keys);
+
+	for (auto& k : odd)
+	{
+		++k;
+	}
+
+	BinarySearchTree<int> a(keys);
+	BinarySearchTree<int> b(odd);
+
+	for (auto _ : state)
+	{
+		vector<int> all = a.preorder();
+		vector<int> more = b.preorder();
+
+		all.insert(all.end(), more.begin(), more.end());
+
+		BinarySearchTree<int> t(all);
+		benchmark::DoNotOptimize(t);
+	}
+
+	state.SetItemsProcessed(state.iterations() * keys.size() * 2);
+}
+BENCHMARK(BM_BSTMergeByInsert)->Apply(sizes);
+
+static void BM_BSTMerge(benchmark::State& state)
+{
+	vector<int> keys = makeKeys(state.range(0), static_cast<int>(state.range(1)));
+	vector<int> odd(keys);
+
+	for (auto& k : odd)
+	{
+		++k;
+	}
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		BinarySearchTree<int> a(keys);
+		BinarySearchTree<int> b(odd);
+		state.ResumeTiming();
+
+		benchmark::DoNotOptimize(BinarySearchTree<int>::merge(std::move(a), std::move(b)));
+	}
+
+	state.SetItemsProcessed(state.iterations() * keys.size() * 2);
+}
+BENCHMARK(BM_BSTMerge)->Apply(sizes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "BinarySearchTree.h"
+#include "FlatBinaryTree.h"
+#include "benchmark/benchmark.h"
+
+using namespace std;
+
+static vector<int> makeKeys(size_t n)
+{
+	vector<int> keys(n);
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		keys[i] = static_cast<int>(i);
+	}
+
+	shuffle(keys.begin(), keys.end(), mt19937(42));
+
+	return keys;
+}
+
+// A random-shaped tree (expected height O(log n)). It is built as a
+// BST and then moved into a plain BinaryTree so that the BinaryTree
+// algorithms run, not the BST overrides.
+static BinaryTree<int> makeTree(size_t n)
+{
+	return BinaryTree<int>(BinarySearchTree<int>(makeKeys(n)));
+}
+
+static void sizes(benchmark::internal::Benchmark* b)
+{
+	b->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18);
+}
+
+template<typename F>
+static void BM_BT(benchmark::State& state, F f)
+{
+	BinaryTree<int> t = makeTree(state.range(0));
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(f(t));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_CAPTURE(BM_BT, inorder, [](BinaryTree<int>& t){ return t.inorder(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, inorderWithoutRecursion, [](BinaryTree<int>& t){ return t.inorderWithoutRecursion(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, inorderMorris, [](BinaryTree<int>& t){ return t.inorderMorris(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, preorder, [](BinaryTree<int>& t){ return t.preorder(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, postorder, [](BinaryTree<int>& t){ return t.postorder(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, size, [](BinaryTree<int>& t){ return t.size(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, height, [](BinaryTree<int>& t){ return t.height(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, width, [](BinaryTree<int>& t){ return t.width(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, leafCount, [](BinaryTree<int>& t){ return t.leafCount(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, isBST, [](BinaryTree<int>& t){ return t.isBST(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, isSumProperty, [](BinaryTree<int>& t){ return t.isSumProperty(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, isBalanced, [](BinaryTree<int>& t){ return t.isBalanced(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, mirror, [](BinaryTree<int>& t){ t.mirror(); return 0; })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, lca, [](BinaryTree<int>& t){ return t.lca(1, 2); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, levelOrder, [](BinaryTree<int>& t){ size_t n = 0; for (auto p : t.levelOrder()) n += p.first; return n; })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, writeLevelOrder, [](BinaryTree<int>& t){ ostringstream out; t.writeLevelOrder(out); return out.tellp(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, writeSpiral, [](BinaryTree<int>& t){ ostringstream out; t.writeSpiral(out); return out.tellp(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_BT, forEachPath, [](BinaryTree<int>& t){ size_t n = 0; t.forEachPath([&n](const int*, size_t length){ n += length; }); return n; })->Apply(sizes);
+
+static void BM_BTToSumProperty(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		BinaryTree<int> t = makeTree(state.range(0));
+		state.ResumeTiming();
+
+		t.toSumProperty();
+		benchmark::DoNotOptimize(t);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BTToSumProperty)->Apply(sizes);
+
+static void BM_BTLCABatch(benchmark::State& state)
+{
+	BinaryTree<int> t = makeTree(state.range(0));
+	vector<int> keys = makeKeys(state.range(0));
+	vector<pair<int, int>> queries;
+
+	for (size_t i = 0; i + 1 < keys.size(); i += 2)
+	{
+		queries.push_back(make_pair(keys[i], keys[i + 1]));
+	}
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(t.lcaBatch(queries));
+	}
+
+	state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK(BM_BTLCABatch)->Apply(sizes);
+
+static void BM_BTFromInorderPreorder(benchmark::State& state)
+{
+	BinaryTree<int> t = makeTree(state.range(0));
+	vector<int> in = t.inorder();
+	vector<int> pre = t.preorder();
+
+	for (auto _ : state)
+	{
+		BinaryTree<int> r = BinaryTree<int>::fromInorderPreorder(in.begin(), in.end(), pre.begin(), pre.end());
+		benchmark::DoNotOptimize(r.stats().nodes);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BTFromInorderPreorder)->Apply(sizes);
+
+template<typename F>
+static void BM_Flat(benchmark::State& state, F f)
+{
+	FlatBinaryTree<int> t(makeTree(state.range(0)));
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(f(t));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_CAPTURE(BM_Flat, inorder, [](FlatBinaryTree<int>& t){ return t.inorder(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Flat, preorder, [](FlatBinaryTree<int>& t){ return t.preorder(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Flat, postorder, [](FlatBinaryTree<int>& t){ return t.postorder(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Flat, levelorder, [](FlatBinaryTree<int>& t){ return t.levelorder(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Flat, height, [](FlatBinaryTree<int>& t){ return t.height(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Flat, leafCount, [](FlatBinaryTree<int>& t){ return t.leafCount(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Flat, isBST, [](FlatBinaryTree<int>& t){ return t.isBST(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Flat, isSumProperty, [](FlatBinaryTree<int>& t){ return t.isSumProperty(); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Flat, mirror, [](FlatBinaryTree<int>& t){ t.mirror(); return 0; })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Flat, lca, [](FlatBinaryTree<int>& t){ return t.lca(1, 2); })->Apply(sizes);
+
+// The kernels alone, scalar against the dispatched (AVX2 if the CPU
+// has it) version, on inputs where they have to look at everything: a
+// sorted array and a complete tree that has the sum property.
+struct SumTree
+{
+	explicit SumTree(size_t n)
+		: keys(n, 1), left(n, kernels::nil), right(n, kernels::nil)
+	{
+		for (size_t i = n; i-- > 0; )
+		{
+			if (2 * i + 1 < n)
+				left[i] = static_cast<uint32_t>(2 * i + 1);
+
+			if (2 * i + 2 < n)
+				right[i] = static_cast<uint32_t>(2 * i + 2);
+
+			if (left[i] != kernels::nil)
+				keys[i] = keys[left[i]] + (right[i] != kernels::nil ? keys[right[i]] : 0);
+		}
+	}
+
+	vector<int> keys;
+	vector<uint32_t> left;
+	vector<uint32_t> right;
+};
+
+template<typename F>
+static void BM_Kernel(benchmark::State& state, F f)
+{
+	SumTree t(state.range(0));
+	vector<int> sorted(state.range(0));
+
+	for (size_t i = 0; i < sorted.size(); ++i)
+	{
+		sorted[i] = static_cast<int>(i);
+	}
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(f(t, sorted));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_CAPTURE(BM_Kernel, isStrictlyIncreasingScalar, [](SumTree&, vector<int>& v){ return kernels::isStrictlyIncreasingScalar(v.data(), v.size()); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Kernel, isStrictlyIncreasing, [](SumTree&, vector<int>& v){ return kernels::isStrictlyIncreasing(v.data(), v.size()); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Kernel, leafCountScalar, [](SumTree& t, vector<int>&){ return kernels::leafCountScalar(t.left.data(), t.right.data(), t.keys.size()); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Kernel, leafCount, [](SumTree& t, vector<int>&){ return kernels::leafCount(t.left.data(), t.right.data(), t.keys.size()); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Kernel, isSumPropertyScalar, [](SumTree& t, vector<int>&){ return kernels::isSumPropertyScalar(t.keys.data(), t.left.data(), t.right.data(), t.keys.size()); })->Apply(sizes);
+BENCHMARK_CAPTURE(BM_Kernel, isSumProperty, [](SumTree& t, vector<int>&){ return kernels::isSumProperty(t.keys.data(), t.left.data(), t.right.data(), t.keys.size()); })->Apply(sizes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,396 @@
+#include <random>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "HashTable.h"
+#include "FixedHashTable.h"
+#include "CuckooHashTable.h"
+#include "BloomFilter.h"
+#include "PreFilter.h"
+#include "RobinHoodHashTable.h"
+#include "benchmark/benchmark.h"
+
+using namespace std;
+
+// Number of buckets in every table. The load factor is then the
+// number of keys divided by this.
+static const size_t Buckets = 1 << 16;
+
+enum Distribution { Sequential, Random, Strided };
+
+static vector<int> makeKeys(size_t n, int distribution)
+{
+	vector<int> keys(n);
+	mt19937 gen(42);
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		switch (distribution)
+		{
+		case Sequential:
+			keys[i] = static_cast<int>(i);
+			break;
+		case Random:
+			keys[i] = static_cast<int>(gen() >> 1);
+			break;
+		case Strided:
+			// Only one bucket in 64 gets used: long chains.
+			keys[i] = static_cast<int>(i * 64);
+			break;
+		}
+	}
+
+	return keys;
+}
+
+// Arguments: load factor in percent, key distribution.
+static void loadFactors(benchmark::internal::Benchmark* b)
+{
+	for (int distribution : { Sequential, Random, Strided })
+	{
+		for (int percent : { 25, 50, 100, 200, 400 })
+		{
+			b->Args({ percent, distribution });
+		}
+	}
+}
+
+static void BM_HashTablePut(benchmark::State& state)
+{
+	size_t n = Buckets * state.range(0) / 100;
+	vector<int> keys = makeKeys(n, static_cast<int>(state.range(1)));
+
+	for (auto _ : state)
+	{
+		HashTable<int, int> h(Buckets);
+
+		for (const auto& k : keys)
+		{
+			h.put(k, k);
+		}
+
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_HashTablePut)->Apply(loadFactors);
+
+static void BM_HashTableGet(benchmark::State& state)
+{
+	size_t n = Buckets * state.range(0) / 100;
+	vector<int> keys = makeKeys(n, static_cast<int>(state.range(1)));
+
+	HashTable<int, int> h(Buckets);
+
+	for (const auto& k : keys)
+	{
+		h.put(k, k);
+	}
+
+	shuffle(keys.begin(), keys.end(), mt19937(7));
+
+	for (auto _ : state)
+	{
+		for (const auto& k : keys)
+		{
+			benchmark::DoNotOptimize(h.get(k));
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_HashTableGet)->Apply(loadFactors);
+
+// Per-request scratch map: build, fill with 48 keys, read them back.
+static void BM_HashTableScratch(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		HashTable<int, int> h(64);
+
+		for (int k = 0; k < 48; ++k)
+		{
+			h.put(k * 3, k);
+		}
+
+		int sum = 0;
+
+		for (int k = 0; k < 48; ++k)
+		{
+			sum += h.get(k * 3);
+		}
+
+		benchmark::DoNotOptimize(sum);
+	}
+}
+BENCHMARK(BM_HashTableScratch);
+
+static void BM_FixedHashTableScratch(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		FixedHashTable<int, int, 64> h;
+
+		for (int k = 0; k < 48; ++k)
+		{
+			h.put(k * 3, k);
+		}
+
+		int sum = 0;
+
+		for (int k = 0; k < 48; ++k)
+		{
+			sum += h.get(k * 3);
+		}
+
+		benchmark::DoNotOptimize(sum);
+	}
+}
+BENCHMARK(BM_FixedHashTableScratch);
+
+// Lookups of absent keys at 4 keys per bucket, with and without a
+// Bloom filter in front.
+static void BM_HashTableMiss(benchmark::State& state)
+{
+	size_t n = Buckets * 4;
+	vector<int> keys = makeKeys(n, Random);
+
+	HashTable<int, int> h(Buckets);
+
+	for (const auto& k : keys)
+	{
+		h.put(k, k);
+	}
+
+	for (auto _ : state)
+	{
+		for (const auto& k : keys)
+		{
+			benchmark::DoNotOptimize(h.find(-k - 1));
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_HashTableMiss);
+
+static void BM_FilteredHashTableMiss(benchmark::State& state)
+{
+	size_t n = Buckets * 4;
+	vector<int> keys = makeKeys(n, Random);
+
+	FilteredHashTable<int, int, BloomFilter<int>> h(Buckets, BloomFilter<int>(n));
+
+	for (const auto& k : keys)
+	{
+		h.put(k, k);
+	}
+
+	for (auto _ : state)
+	{
+		for (const auto& k : keys)
+		{
+			benchmark::DoNotOptimize(h.find(-k - 1));
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_FilteredHashTableMiss);
+
+// Insert/erase churn at a 1:1 ratio: a sliding window of n live keys,
+// each step erasing the oldest key, inserting a new one and looking
+// one up. The window slides over 16n keys per iteration, long enough
+// for any decay (tombstones, skewed chains) to show. Argument: keys
+// per slot in percent, both tables having Buckets slots.
+template<typename Table>
+static void churn(benchmark::State& state, Table& h)
+{
+	size_t n = Buckets * state.range(0) / 100;
+	vector<int> keys = makeKeys(n * 17, Random);
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		h.put(keys[i], 0);
+	}
+
+	for (auto _ : state)
+	{
+		for (size_t i = n; i < keys.size(); ++i)
+		{
+			h.erase(keys[i - n]);
+			h.put(keys[i], 0);
+			benchmark::DoNotOptimize(h.find(keys[i - n / 2]));
+		}
+
+		// Back to the starting window.
+		state.PauseTiming();
+
+		for (size_t i = keys.size() - n; i < keys.size(); ++i)
+		{
+			h.erase(keys[i]);
+		}
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			h.put(keys[i], 0);
+		}
+
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed(state.iterations() * (keys.size() - n));
+}
+
+static void BM_HashTableChurn(benchmark::State& state)
+{
+	HashTable<int, int> h(Buckets);
+
+	churn(state, h);
+}
+BENCHMARK(BM_HashTableChurn)->Arg(50)->Arg(90);
+
+static void BM_RobinHoodHashTableChurn(benchmark::State& state)
+{
+	RobinHoodHashTable<int, int> h(Buckets * 9 / 10);
+
+	churn(state, h);
+	state.counters["load"] = h.loadFactor();
+}
+BENCHMARK(BM_RobinHoodHashTableChurn)->Arg(50)->Arg(90);
+
+// Checkpoint and restore of 4M entries through exportTo/importFrom.
+static const size_t SnapshotSize = 1 << 22;
+
+static void BM_HashTableExport(benchmark::State& state)
+{
+	vector<int> keys = makeKeys(SnapshotSize, Sequential);
+	HashTable<int, int> h(SnapshotSize);
+
+	h.importFrom(keys.data(), keys.data(), keys.size());
+
+	vector<int> k(h.size());
+	vector<int> v(h.size());
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(h.exportTo(k.data(), v.data()));
+	}
+
+	state.SetItemsProcessed(state.iterations() * SnapshotSize);
+}
+BENCHMARK(BM_HashTableExport)->Unit(benchmark::kMillisecond);
+
+// Argument: threads, 0 for every core. The put loop is the baseline.
+static void BM_HashTableImport(benchmark::State& state)
+{
+	vector<int> keys = makeKeys(SnapshotSize, Random);
+
+	for (auto _ : state)
+	{
+		HashTable<int, int> h(16);
+
+		h.importFrom(keys.data(), keys.data(), keys.size(), state.range(0));
+		benchmark::DoNotOptimize(h.size());
+	}
+
+	state.SetItemsProcessed(state.iterations() * SnapshotSize);
+}
+BENCHMARK(BM_HashTableImport)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_HashTablePutAll(benchmark::State& state)
+{
+	vector<int> keys = makeKeys(SnapshotSize, Random);
+
+	for (auto _ : state)
+	{
+		HashTable<int, int> h(16);
+
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			if (h.size() == h.bucketCount())
+				h.rehash(2 * h.bucketCount());
+
+			h.put(keys[i], keys[i]);
+		}
+
+		benchmark::DoNotOptimize(h.size());
+	}
+
+	state.SetItemsProcessed(state.iterations() * SnapshotSize);
+}
+BENCHMARK(BM_HashTablePutAll)->Unit(benchmark::kMillisecond);
+
+// Lookup latency percentiles. Every lookup is timed on its own, so the
+// numbers include the clock overhead (some tens of ns), the same for
+// both tables. Arguments: keys per slot in percent, key distribution.
+template<typename Table>
+static void lookupLatency(benchmark::State& state, Table& h, size_t n)
+{
+	vector<int> keys = makeKeys(n, static_cast<int>(state.range(1)));
+
+	for (const auto& k : keys)
+	{
+		h.put(k, k);
+	}
+
+	shuffle(keys.begin(), keys.end(), mt19937(7));
+
+	vector<double> ns;
+	ns.reserve(keys.size() * 16);
+
+	for (auto _ : state)
+	{
+		for (const auto& k : keys)
+		{
+			auto start = chrono::steady_clock::now();
+			benchmark::DoNotOptimize(h.get(k));
+			auto end = chrono::steady_clock::now();
+
+			if (ns.size() < ns.capacity())
+				ns.push_back(chrono::duration<double, nano>(end - start).count());
+		}
+	}
+
+	sort(ns.begin(), ns.end());
+
+	state.counters["p50"] = ns[ns.size() / 2];
+	state.counters["p99"] = ns[ns.size() * 99 / 100];
+	state.counters["p999"] = ns[ns.size() * 999 / 1000];
+	state.counters["max"] = ns.back();
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void highLoadFactors(benchmark::internal::Benchmark* b)
+{
+	for (int distribution : { Random, Strided })
+	{
+		for (int percent : { 50, 80, 95 })
+		{
+			b->Args({ percent, distribution });
+		}
+	}
+}
+
+// Both tables get Buckets slots: chains for HashTable, 4-way buckets
+// for CuckooHashTable.
+static void BM_HashTableLatency(benchmark::State& state)
+{
+	HashTable<int, int> h(Buckets);
+
+	lookupLatency(state, h, Buckets * state.range(0) / 100);
+}
+BENCHMARK(BM_HashTableLatency)->Apply(highLoadFactors);
+
+static void BM_CuckooHashTableLatency(benchmark::State& state)
+{
+	CuckooHashTable<int, int> h(Buckets);
+
+	lookupLatency(state, h, Buckets * state.range(0) / 100);
+	state.counters["load"] = h.loadFactor();
+}
+BENCHMARK(BM_CuckooHashTableLatency)->Apply(highLoadFactors);
+
+BENCHMARK_MAIN();
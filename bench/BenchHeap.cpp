@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "DaryHeap.h"
+#include "IndexedHeap.h"
+#include "PairingHeap.h"
+#include "benchmark/benchmark.h"
+
+using namespace std;
+
+static vector<int> makeValues(size_t n)
+{
+	mt19937 gen(42);
+	uniform_int_distribution<int> value(0, 1 << 30);
+	vector<int> v(n);
+
+	for (auto& x : v)
+	{
+		x = value(gen);
+	}
+
+	return v;
+}
+
+static void sizes(benchmark::internal::Benchmark* b)
+{
+	b->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18);
+}
+
+typedef priority_queue<int, vector<int>, greater<int>> StdMinHeap;
+
+// Push every value, then pop them all.
+template<typename Heap>
+static void pushPop(benchmark::State& state, Heap& h)
+{
+	vector<int> values = makeValues(state.range(0));
+
+	for (auto _ : state)
+	{
+		long long sum = 0;
+
+		for (int x : values)
+		{
+			h.push(x);
+		}
+
+		while (!h.empty())
+		{
+			sum += h.top();
+			h.pop();
+		}
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void BM_StdPriorityQueuePushPop(benchmark::State& state)
+{
+	StdMinHeap h;
+
+	pushPop(state, h);
+}
+BENCHMARK(BM_StdPriorityQueuePushPop)->Apply(sizes);
+
+static void BM_DaryHeap2PushPop(benchmark::State& state)
+{
+	DaryHeap<int, 2> h;
+
+	pushPop(state, h);
+}
+BENCHMARK(BM_DaryHeap2PushPop)->Apply(sizes);
+
+static void BM_DaryHeap4PushPop(benchmark::State& state)
+{
+	DaryHeap<int, 4> h;
+
+	pushPop(state, h);
+}
+BENCHMARK(BM_DaryHeap4PushPop)->Apply(sizes);
+
+static void BM_DaryHeap8PushPop(benchmark::State& state)
+{
+	DaryHeap<int, 8> h;
+
+	pushPop(state, h);
+}
+BENCHMARK(BM_DaryHeap8PushPop)->Apply(sizes);
+
+static void BM_PairingHeapPushPop(benchmark::State& state)
+{
+	PairingHeap<int> h;
+
+	pushPop(state, h);
+}
+BENCHMARK(BM_PairingHeapPushPop)->Apply(sizes);
+
+static void BM_StdMakeHeap(benchmark::State& state)
+{
+	vector<int> values = makeValues(state.range(0));
+
+	for (auto _ : state)
+	{
+		StdMinHeap h(greater<int>(), values);
+		benchmark::DoNotOptimize(h.top());
+	}
+
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(BM_StdMakeHeap)->Apply(sizes);
+
+static void BM_DaryHeap4Heapify(benchmark::State& state)
+{
+	vector<int> values = makeValues(state.range(0));
+
+	for (auto _ : state)
+	{
+		DaryHeap<int, 4> h(values.begin(), values.end());
+		benchmark::DoNotOptimize(h.top());
+	}
+
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(BM_DaryHeap4Heapify)->Apply(sizes);
+
+// A Dijkstra-like mix on n keys: each pop lowers the priority of four
+// keys still queued. std::priority_queue cannot do that, so it gets a
+// fresh copy of the key and skips stale ones when they come up.
+static void BM_StdPriorityQueueDecreaseKey(benchmark::State& state)
+{
+	size_t n = state.range(0);
+	vector<int> values = makeValues(n);
+	mt19937 gen(7);
+	uniform_int_distribution<size_t> pick(0, n - 1);
+
+	for (auto _ : state)
+	{
+		priority_queue<pair<int, size_t>, vector<pair<int, size_t>>, greater<pair<int, size_t>>> h;
+		vector<int> priority = values;
+		vector<bool> done(n, false);
+
+		for (size_t k = 0; k < n; ++k)
+		{
+			h.push(make_pair(priority[k], k));
+		}
+
+		while (!h.empty())
+		{
+			pair<int, size_t> top = h.top();
+			h.pop();
+
+			if (done[top.second] || top.first != priority[top.second])
+				continue;
+
+			done[top.second] = true;
+
+			for (int i = 0; i < 4; ++i)
+			{
+				size_t k = pick(gen);
+
+				if (!done[k])
+				{
+					priority[k] -= 1000;
+					h.push(make_pair(priority[k], k));
+				}
+			}
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_StdPriorityQueueDecreaseKey)->Apply(sizes);
+
+static void BM_IndexedHeapDecreaseKey(benchmark::State& state)
+{
+	size_t n = state.range(0);
+	vector<int> values = makeValues(n);
+	mt19937 gen(7);
+	uniform_int_distribution<size_t> pick(0, n - 1);
+
+	for (auto _ : state)
+	{
+		IndexedHeap<size_t, int> h(n);
+		vector<int> priority = values;
+
+		for (size_t k = 0; k < n; ++k)
+		{
+			h.push(k, priority[k]);
+		}
+
+		while (!h.empty())
+		{
+			h.pop();
+
+			for (int i = 0; i < 4; ++i)
+			{
+				size_t k = pick(gen);
+
+				priority[k] -= 1000;
+				h.decreaseKey(k, priority[k]);
+			}
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_IndexedHeapDecreaseKey)->Apply(sizes);
+
+static void BM_PairingHeapDecreaseKey(benchmark::State& state)
+{
+	size_t n = state.range(0);
+	vector<int> values = makeValues(n);
+	mt19937 gen(7);
+	uniform_int_distribution<size_t> pick(0, n - 1);
+
+	for (auto _ : state)
+	{
+		PairingHeap<pair<int, size_t>> h;
+		vector<PairingHeap<pair<int, size_t>>::Handle> handles(n);
+		vector<int> priority = values;
+		vector<bool> done(n, false);
+
+		for (size_t k = 0; k < n; ++k)
+		{
+			handles[k] = h.push(make_pair(priority[k], k));
+		}
+
+		while (!h.empty())
+		{
+			done[h.top().second] = true;
+			h.pop();
+
+			for (int i = 0; i < 4; ++i)
+			{
+				size_t k = pick(gen);
+
+				if (!done[k])
+				{
+					priority[k] -= 1000;
+					h.decreaseKey(handles[k], make_pair(priority[k], k));
+				}
+			}
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_PairingHeapDecreaseKey)->Apply(sizes);
+
+BENCHMARK_MAIN();
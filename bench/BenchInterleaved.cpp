@@ -0,0 +1,164 @@
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Interleaved.h"
+#include "benchmark/benchmark.h"
+
+using namespace std;
+
+// Arguments: number of keys, lookups in flight (0 for a plain loop).
+// Sizes go from in-cache to far beyond it: a BST node is 24 bytes, a
+// HashTable entry about 56 with its bucket, so the largest table is
+// about 1 GB. Structures are built once per size, as the big ones take
+// seconds.
+static void widths(benchmark::internal::Benchmark* b, int n)
+{
+	for (int width : { 0, 4, 8, 16, 32 })
+	{
+		b->Args({ n, width });
+	}
+}
+
+static void treeSizes(benchmark::internal::Benchmark* b)
+{
+	widths(b, 1 << 16);
+	widths(b, 1 << 22);
+	widths(b, 1 << 24);
+}
+
+static void tableSizes(benchmark::internal::Benchmark* b)
+{
+	widths(b, 1 << 16);
+	widths(b, 1 << 24);
+}
+
+// n even keys in random order; lookups draw from twice the range, so
+// about half of them hit.
+static vector<int> makeKeys(size_t n)
+{
+	vector<int> keys(n);
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		keys[i] = static_cast<int>(2 * i);
+	}
+
+	shuffle(keys.begin(), keys.end(), mt19937(42));
+
+	return keys;
+}
+
+static vector<int> makeLookups(size_t n)
+{
+	mt19937 gen(7);
+	uniform_int_distribution<int> key(0, static_cast<int>(2 * n - 1));
+	vector<int> v(4096);
+
+	for (auto& k : v)
+	{
+		k = key(gen);
+	}
+
+	return v;
+}
+
+static const BinarySearchTree<int>& tree(size_t n)
+{
+	static unique_ptr<BinarySearchTree<int>> t;
+	static size_t size = 0;
+
+	if (size != n)
+	{
+		t.reset();
+		t.reset(new BinarySearchTree<int>(makeKeys(n)));
+		size = n;
+	}
+
+	return *t;
+}
+
+static HashTable<int, int>& table(size_t n)
+{
+	static unique_ptr<HashTable<int, int>> t;
+	static size_t size = 0;
+
+	if (size != n)
+	{
+		t.reset();
+		t.reset(new HashTable<int, int>(n));
+
+		for (int k : makeKeys(n))
+		{
+			t->put(k, k);
+		}
+
+		size = n;
+	}
+
+	return *t;
+}
+
+static void BM_BSTContainsBatch(benchmark::State& state)
+{
+	const BinarySearchTree<int>& t = tree(state.range(0));
+	vector<int> lookups = makeLookups(state.range(0));
+	size_t width = state.range(1);
+
+	for (auto _ : state)
+	{
+		size_t hits = 0;
+
+		if (width == 0)
+		{
+			for (int k : lookups)
+			{
+				hits += t.contains(k);
+			}
+		}
+		else
+		{
+			Interleaved::interleave(lookups.size(), width,
+					[&](size_t i) { return Interleaved::contains(t, lookups[i]); },
+					[&](size_t, bool hit) { hits += hit; });
+		}
+
+		benchmark::DoNotOptimize(hits);
+	}
+
+	state.SetItemsProcessed(state.iterations() * lookups.size());
+}
+BENCHMARK(BM_BSTContainsBatch)->Apply(treeSizes);
+
+static void BM_HashTableFindBatch(benchmark::State& state)
+{
+	HashTable<int, int>& t = table(state.range(0));
+	vector<int> lookups = makeLookups(state.range(0));
+	size_t width = state.range(1);
+
+	for (auto _ : state)
+	{
+		size_t hits = 0;
+
+		if (width == 0)
+		{
+			for (int k : lookups)
+			{
+				hits += t.find(k) != nullptr;
+			}
+		}
+		else
+		{
+			Interleaved::interleave(lookups.size(), width,
+					[&](size_t i) { return Interleaved::find(t, lookups[i]); },
+					[&](size_t, int* value) { hits += value != nullptr; });
+		}
+
+		benchmark::DoNotOptimize(hits);
+	}
+
+	state.SetItemsProcessed(state.iterations() * lookups.size());
+}
+BENCHMARK(BM_HashTableFindBatch)->Apply(tableSizes);
+
+BENCHMARK_MAIN();
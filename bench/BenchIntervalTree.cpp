@@ -0,0 +1,149 @@
+#include <random>
+#include <vector>
+
+#include "IntervalTree.h"
+#include "benchmark/benchmark.h"
+
+using namespace std;
+
+// n windows starting anywhere in [0, 1000 n) and up to 2000 long, so
+// a point is in about one of them.
+static vector<Interval<int>> makeIntervals(size_t n)
+{
+	mt19937 gen(42);
+	uniform_int_distribution<int> start(0, static_cast<int>(n * 1000));
+	uniform_int_distribution<int> length(0, 2000);
+	vector<Interval<int>> v(n);
+
+	for (auto& i : v)
+	{
+		i.lo = start(gen);
+		i.hi = i.lo + length(gen);
+	}
+
+	return v;
+}
+
+static vector<int> makePoints(size_t n)
+{
+	mt19937 gen(7);
+	uniform_int_distribution<int> point(0, static_cast<int>(n * 1000));
+	vector<int> v(1024);
+
+	for (auto& p : v)
+	{
+		p = point(gen);
+	}
+
+	return v;
+}
+
+static void sizes(benchmark::internal::Benchmark* b)
+{
+	b->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18);
+}
+
+static void BM_IntervalScanStab(benchmark::State& state)
+{
+	vector<Interval<int>> intervals = makeIntervals(state.range(0));
+	vector<int> points = makePoints(state.range(0));
+
+	for (auto _ : state)
+	{
+		size_t hits = 0;
+
+		for (int p : points)
+		{
+			for (const auto& i : intervals)
+			{
+				hits += i.overlaps(p, p);
+			}
+		}
+
+		benchmark::DoNotOptimize(hits);
+	}
+
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_IntervalScanStab)->Apply(sizes);
+
+static void BM_IntervalTreeStab(benchmark::State& state)
+{
+	vector<Interval<int>> intervals = makeIntervals(state.range(0));
+	vector<int> points = makePoints(state.range(0));
+	IntervalTree<int> t(intervals.begin(), intervals.end());
+
+	for (auto _ : state)
+	{
+		size_t hits = 0;
+
+		for (int p : points)
+		{
+			t.stab(p, [&hits](const Interval<int>&) { ++hits; });
+		}
+
+		benchmark::DoNotOptimize(hits);
+	}
+
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_IntervalTreeStab)->Apply(sizes);
+
+// Windows of 100 000, about a hundred results each.
+static void BM_IntervalTreeOverlap(benchmark::State& state)
+{
+	vector<Interval<int>> intervals = makeIntervals(state.range(0));
+	vector<int> points = makePoints(state.range(0));
+	IntervalTree<int> t(intervals.begin(), intervals.end());
+
+	for (auto _ : state)
+	{
+		size_t hits = 0;
+
+		for (int p : points)
+		{
+			t.overlap(p, p + 100000, [&hits](const Interval<int>&) { ++hits; });
+		}
+
+		benchmark::DoNotOptimize(hits);
+	}
+
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_IntervalTreeOverlap)->Apply(sizes);
+
+static void BM_IntervalTreeBulkBuild(benchmark::State& state)
+{
+	vector<Interval<int>> intervals = makeIntervals(state.range(0));
+
+	for (auto _ : state)
+	{
+		IntervalTree<int> t(intervals.begin(), intervals.end());
+		benchmark::DoNotOptimize(t.size());
+	}
+
+	state.SetItemsProcessed(state.iterations() * intervals.size());
+}
+BENCHMARK(BM_IntervalTreeBulkBuild)->Apply(sizes);
+
+static void BM_IntervalTreeInsert(benchmark::State& state)
+{
+	vector<Interval<int>> intervals = makeIntervals(state.range(0));
+
+	for (auto _ : state)
+	{
+		IntervalTree<int> t;
+
+		for (const auto& i : intervals)
+		{
+			t.insert(i.lo, i.hi);
+		}
+
+		benchmark::DoNotOptimize(t.size());
+	}
+
+	state.SetItemsProcessed(state.iterations() * intervals.size());
+}
+BENCHMARK(BM_IntervalTreeInsert)->Apply(sizes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,136 @@
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "SegmentTree.h"
+#include "FenwickTree.h"
+#include "benchmark/benchmark.h"
+
+using namespace std;
+
+static vector<long> makeValues(size_t n)
+{
+	mt19937 gen(42);
+	vector<long> v(n);
+
+	for (auto& x : v)
+	{
+		x = static_cast<long>(gen() % 1000);
+	}
+
+	return v;
+}
+
+// 1024 random [first, last) ranges.
+static vector<pair<size_t, size_t>> makeRanges(size_t n)
+{
+	mt19937 gen(7);
+	vector<pair<size_t, size_t>> ranges(1024);
+
+	for (auto& r : ranges)
+	{
+		size_t a = gen() % (n + 1);
+		size_t b = gen() % (n + 1);
+
+		r = a < b ? make_pair(a, b) : make_pair(b, a);
+	}
+
+	return ranges;
+}
+
+static void sizes(benchmark::internal::Benchmark* b)
+{
+	b->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18);
+}
+
+static void BM_ScanSum(benchmark::State& state)
+{
+	vector<long> v = makeValues(state.range(0));
+	vector<pair<size_t, size_t>> ranges = makeRanges(v.size());
+
+	for (auto _ : state)
+	{
+		long total = 0;
+
+		for (const auto& r : ranges)
+		{
+			total += accumulate(v.begin() + r.first, v.begin() + r.second, 0L);
+		}
+
+		benchmark::DoNotOptimize(total);
+	}
+
+	state.SetItemsProcessed(state.iterations() * ranges.size());
+}
+BENCHMARK(BM_ScanSum)->Apply(sizes);
+
+static void BM_SegmentTreeSum(benchmark::State& state)
+{
+	vector<long> v = makeValues(state.range(0));
+	vector<pair<size_t, size_t>> ranges = makeRanges(v.size());
+	SegmentTree<long> t(v.begin(), v.end());
+
+	for (auto _ : state)
+	{
+		long total = 0;
+
+		for (const auto& r : ranges)
+		{
+			total += t.query(r.first, r.second);
+		}
+
+		benchmark::DoNotOptimize(total);
+	}
+
+	state.SetItemsProcessed(state.iterations() * ranges.size());
+}
+BENCHMARK(BM_SegmentTreeSum)->Apply(sizes);
+
+// A range add then a range query, lazily.
+static void BM_SegmentTreeAddQuery(benchmark::State& state)
+{
+	vector<long> v = makeValues(state.range(0));
+	vector<pair<size_t, size_t>> ranges = makeRanges(v.size());
+	SegmentTree<long, MinOp<long>> t(v.begin(), v.end());
+
+	for (auto _ : state)
+	{
+		long total = 0;
+
+		for (const auto& r : ranges)
+		{
+			t.add(r.first, r.second, 1);
+			total += t.query(r.second / 2, r.second);
+		}
+
+		benchmark::DoNotOptimize(total);
+	}
+
+	state.SetItemsProcessed(state.iterations() * ranges.size());
+}
+BENCHMARK(BM_SegmentTreeAddQuery)->Apply(sizes);
+
+static void BM_FenwickTreeSum(benchmark::State& state)
+{
+	vector<long> v = makeValues(state.range(0));
+	vector<pair<size_t, size_t>> ranges = makeRanges(v.size());
+	FenwickTree<long> t(v.begin(), v.end());
+
+	for (auto _ : state)
+	{
+		long total = 0;
+
+		for (const auto& r : ranges)
+		{
+			t.add(r.first, 1);
+			total += t.sum(r.first, r.second);
+		}
+
+		benchmark::DoNotOptimize(total);
+	}
+
+	state.SetItemsProcessed(state.iterations() * ranges.size());
+}
+BENCHMARK(BM_FenwickTreeSum)->Apply(sizes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,1148 @@
+#ifndef ADAPTIVERADIXTREE_H
+#define ADAPTIVERADIXTREE_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Adaptive radix tree (Leis et al., ICDE 2013) mapping std::string keys
+// to V. Each inner node branches on one byte of the key and comes in
+// four sizes, grown and shrunk as children come and go:
+//   - Node4 and Node16: sorted key bytes beside the children; Node16
+//     compares all 16 bytes at once with SSE2;
+//   - Node48: a 256-entry byte index into 48 children;
+//   - Node256: one child per byte.
+// A lookup costs O(key length) whatever the number of keys, and reads
+// one byte per level instead of comparing whole strings as a BST does.
+//
+// Paths with a single child are compressed into the node below them
+// (its prefix). Only the first 8 bytes of a prefix are kept; a longer
+// one is skipped on lookup and checked against the full key kept in
+// every entry. Entries hang off the tree directly, without a Node4 of
+// their own when they are alone below a byte. A key that is a prefix of
+// another lives in the inner node where it ends, so any bytes, '\0'
+// included, can be in a key.
+//
+// Entries are visited in key order, comparing bytes as unsigned char
+// (std::string's order for ASCII).
+template<typename V>
+class AdaptiveRadixTree
+{
+public:
+	struct Entry
+	{
+		std::string key;
+		V value;
+	};
+
+	AdaptiveRadixTree()
+		: root_(0), size_(0), bytes_(0)
+	{	}
+
+	~AdaptiveRadixTree()
+	{
+		clear();
+	}
+
+	AdaptiveRadixTree(const AdaptiveRadixTree&) = delete;
+	AdaptiveRadixTree& operator=(const AdaptiveRadixTree&) = delete;
+
+	AdaptiveRadixTree(AdaptiveRadixTree&& t)
+		: root_(t.root_), size_(t.size_), bytes_(t.bytes_)
+	{
+		t.root_ = 0;
+		t.size_ = 0;
+		t.bytes_ = 0;
+	}
+
+	AdaptiveRadixTree& operator=(AdaptiveRadixTree&& t)
+	{
+		if (this != &t)
+		{
+			clear();
+			std::swap(root_, t.root_);
+			std::swap(size_, t.size_);
+			std::swap(bytes_, t.bytes_);
+		}
+
+		return *this;
+	}
+
+	// Adds key or replaces its value. True if key was not there.
+	bool put(const std::string& key, const V& value);
+
+	// Pointer to the value of key, or nullptr.
+	V* find(const std::string& key)
+	{
+		Entry* e = lookup(key);
+
+		return e ? &e->value : nullptr;
+	}
+
+	const V* find(const std::string& key) const
+	{
+		const Entry* e = lookup(key);
+
+		return e ? &e->value : nullptr;
+	}
+
+	bool contains(const std::string& key) const
+	{
+		return lookup(key) != nullptr;
+	}
+
+	// Returns false if key was not there.
+	bool erase(const std::string& key);
+
+	void clear();
+
+	size_t size() const
+	{
+		return size_;
+	}
+
+	bool empty() const
+	{
+		return size_ == 0;
+	}
+
+	// Bytes held by the nodes and the entries. Key buffers too long for
+	// the string's own storage are not counted.
+	size_t bytes() const
+	{
+		return bytes_;
+	}
+
+	// Calls f(key, value) for every entry, in key order.
+	template<typename F>
+	void forEach(F f) const
+	{
+		walk(root_, f);
+	}
+
+	// Calls f(key, value), in key order, for every key starting with
+	// prefix. O(|prefix| + k) for k results.
+	template<typename F>
+	void forEachPrefix(const std::string& prefix, F f) const;
+
+	// The entry with the longest key that is a prefix of key (key
+	// itself included), or nullptr. O(|key|).
+	const Entry* longestPrefix(const std::string& key) const;
+
+private:
+	// A child: an Inner*, or an Entry* with the low bit set.
+	typedef uintptr_t Link;
+
+	static const size_t maxPrefix = 8;
+
+	struct Inner
+	{
+		uint8_t type;
+		uint16_t count;
+		uint32_t prefixLength;
+		unsigned char prefix[maxPrefix];
+		Entry* value;				// the key ending here, if any
+	};
+
+	struct Node4 : Inner
+	{
+		static const uint8_t kind = 0;
+
+		unsigned char keys[4];
+		Link children[4];
+	};
+
+	struct Node16 : Inner
+	{
+		static const uint8_t kind = 1;
+
+		unsigned char keys[16];
+		Link children[16];
+	};
+
+	struct Node48 : Inner
+	{
+		static const uint8_t kind = 2;
+
+		unsigned char index[256];	// slot + 1, 0 for none
+		Link children[48];
+	};
+
+	struct Node256 : Inner
+	{
+		static const uint8_t kind = 3;
+
+		Link children[256];
+	};
+
+	static bool isLeaf(Link l)
+	{
+		return l & 1;
+	}
+
+	static Entry* asLeaf(Link l)
+	{
+		return reinterpret_cast<Entry*>(l & ~Link(1));
+	}
+
+	static Inner* asInner(Link l)
+	{
+		return reinterpret_cast<Inner*>(l);
+	}
+
+	static Link linkTo(Entry* e)
+	{
+		return reinterpret_cast<Link>(e) | 1;
+	}
+
+	static Link linkTo(Inner* n)
+	{
+		return reinterpret_cast<Link>(n);
+	}
+
+	static unsigned char byteAt(const std::string& key, size_t i)
+	{
+		return static_cast<unsigned char>(key[i]);
+	}
+
+	static bool startsWith(const std::string& s, const std::string& prefix)
+	{
+		return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+	}
+
+	Entry* newEntry(const std::string& key, const V& value)
+	{
+		bytes_ += sizeof(Entry);
+
+		return new Entry{ key, value };
+	}
+
+	void deleteEntry(Entry* e)
+	{
+		bytes_ -= sizeof(Entry);
+		delete e;
+	}
+
+	template<typename N>
+	N* newInner()
+	{
+		N* n = new N();
+
+		n->type = N::kind;
+		bytes_ += sizeof(N);
+
+		return n;
+	}
+
+	void deleteInner(Inner* n);
+
+	// Prefix and value of from, for a node changing size.
+	static void copyHeader(Inner* to, const Inner* from)
+	{
+		to->count = from->count;
+		to->prefixLength = from->prefixLength;
+		std::memcpy(to->prefix, from->prefix, maxPrefix);
+		to->value = from->value;
+	}
+
+	// Slot of the child for byte b, or nullptr.
+	static Link* child(Inner* n, unsigned char b);
+
+	static Link firstChild(Inner* n, unsigned char& b);
+
+	// Calls g(byte, child) in byte order.
+	template<typename G>
+	static void forEachChild(Inner* n, G g);
+
+	// Any entry below n; all of them share n's full prefix.
+	static Entry* minimum(Inner* n);
+
+	// How many bytes of n's prefix key matches from depth, reading the
+	// bytes past maxPrefix from an entry below n.
+	static size_t matchPrefix(Inner* n, const std::string& key, size_t depth);
+
+	static void insertSorted(unsigned char* keys, Link* children, uint16_t& count, unsigned char b, Link c);
+
+	// Adds a child, growing n (and updating *ref) if it is full.
+	void addChild(Link* ref, Inner* n, unsigned char b, Link c);
+
+	// An entry under a new node whose prefix ends at depth.
+	static void place(Node4* n, Entry* e, size_t depth)
+	{
+		if (e->key.size() == depth)
+			n->value = e;
+		else
+			insertSorted(n->keys, n->children, n->count, byteAt(e->key, depth), linkTo(e));
+	}
+
+	static void removeChild(Inner* n, unsigned char b);
+
+	// After a removal from *ref: folds away a node left with one entry
+	// or one child and no entry, or shrinks one that is underfull.
+	void normalize(Link* ref);
+
+	Entry* lookup(const std::string& key) const;
+
+	template<typename F>
+	void walk(Link top, F& f) const;
+
+	Link root_;
+	size_t size_;
+	size_t bytes_;
+};
+
+template<typename V>
+const size_t AdaptiveRadixTree<V>::maxPrefix;
+
+template<typename V>
+void AdaptiveRadixTree<V>::deleteInner(Inner* n)
+{
+	switch (n->type)
+	{
+	case Node4::kind:
+		bytes_ -= sizeof(Node4);
+		delete static_cast<Node4*>(n);
+		break;
+	case Node16::kind:
+		bytes_ -= sizeof(Node16);
+		delete static_cast<Node16*>(n);
+		break;
+	case Node48::kind:
+		bytes_ -= sizeof(Node48);
+		delete static_cast<Node48*>(n);
+		break;
+	default:
+		bytes_ -= sizeof(Node256);
+		delete static_cast<Node256*>(n);
+		break;
+	}
+}
+
+template<typename V>
+typename AdaptiveRadixTree<V>::Link* AdaptiveRadixTree<V>::child(Inner* n, unsigned char b)
+{
+	switch (n->type)
+	{
+	case Node4::kind:
+	{
+		Node4* m = static_cast<Node4*>(n);
+
+		for (unsigned i = 0; i < m->count; ++i)
+		{
+			if (m->keys[i] == b)
+				return &m->children[i];
+		}
+
+		return nullptr;
+	}
+	case Node16::kind:
+	{
+		Node16* m = static_cast<Node16*>(n);
+
+#ifdef __SSE2__
+		// All 16 bytes compared at once; bits past count are stale.
+		__m128i match = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(b)),
+						_mm_loadu_si128(reinterpret_cast<const __m128i*>(m->keys)));
+		unsigned mask = _mm_movemask_epi8(match) & ((1u << m->count) - 1);
+
+		return mask ? &m->children[__builtin_ctz(mask)] : nullptr;
+#else
+		for (unsigned i = 0; i < m->count; ++i)
+		{
+			if (m->keys[i] == b)
+				return &m->children[i];
+		}
+
+		return nullptr;
+#endif
+	}
+	case Node48::kind:
+	{
+		Node48* m = static_cast<Node48*>(n);
+
+		return m->index[b] ? &m->children[m->index[b] - 1] : nullptr;
+	}
+	default:
+	{
+		Node256* m = static_cast<Node256*>(n);
+
+		return m->children[b] ? &m->children[b] : nullptr;
+	}
+	}
+}
+
+template<typename V>
+typename AdaptiveRadixTree<V>::Link AdaptiveRadixTree<V>::firstChild(Inner* n, unsigned char& b)
+{
+	switch (n->type)
+	{
+	case Node4::kind:
+		b = static_cast<Node4*>(n)->keys[0];
+		return static_cast<Node4*>(n)->children[0];
+	case Node16::kind:
+		b = static_cast<Node16*>(n)->keys[0];
+		return static_cast<Node16*>(n)->children[0];
+	case Node48::kind:
+	{
+		Node48* m = static_cast<Node48*>(n);
+
+		for (unsigned i = 0; i < 256; ++i)
+		{
+			if (m->index[i])
+			{
+				b = static_cast<unsigned char>(i);
+				return m->children[m->index[i] - 1];
+			}
+		}
+
+		return 0;
+	}
+	default:
+	{
+		Node256* m = static_cast<Node256*>(n);
+
+		for (unsigned i = 0; i < 256; ++i)
+		{
+			if (m->children[i])
+			{
+				b = static_cast<unsigned char>(i);
+				return m->children[i];
+			}
+		}
+
+		return 0;
+	}
+	}
+}
+
+template<typename V>
+template<typename G>
+void AdaptiveRadixTree<V>::forEachChild(Inner* n, G g)
+{
+	switch (n->type)
+	{
+	case Node4::kind:
+	{
+		Node4* m = static_cast<Node4*>(n);
+
+		for (unsigned i = 0; i < m->count; ++i)
+		{
+			g(m->keys[i], m->children[i]);
+		}
+
+		break;
+	}
+	case Node16::kind:
+	{
+		Node16* m = static_cast<Node16*>(n);
+
+		for (unsigned i = 0; i < m->count; ++i)
+		{
+			g(m->keys[i], m->children[i]);
+		}
+
+		break;
+	}
+	case Node48::kind:
+	{
+		Node48* m = static_cast<Node48*>(n);
+
+		for (unsigned i = 0; i < 256; ++i)
+		{
+			if (m->index[i])
+				g(static_cast<unsigned char>(i), m->children[m->index[i] - 1]);
+		}
+
+		break;
+	}
+	default:
+	{
+		Node256* m = static_cast<Node256*>(n);
+
+		for (unsigned i = 0; i < 256; ++i)
+		{
+			if (m->children[i])
+				g(static_cast<unsigned char>(i), m->children[i]);
+		}
+
+		break;
+	}
+	}
+}
+
+template<typename V>
+typename AdaptiveRadixTree<V>::Entry* AdaptiveRadixTree<V>::minimum(Inner* n)
+{
+	while (!n->value)
+	{
+		unsigned char b;
+		Link c = firstChild(n, b);
+
+		if (isLeaf(c))
+			return asLeaf(c);
+
+		n = asInner(c);
+	}
+
+	return n->value;
+}
+
+template<typename V>
+size_t AdaptiveRadixTree<V>::matchPrefix(Inner* n, const std::string& key, size_t depth)
+{
+	size_t limit = std::min<size_t>(n->prefixLength, key.size() - depth);
+	size_t stored = std::min(limit, maxPrefix);
+	size_t i = 0;
+
+	for (; i < stored; ++i)
+	{
+		if (n->prefix[i] != byteAt(key, depth + i))
+			return i;
+	}
+
+	if (i < limit)
+	{
+		const std::string& full = minimum(n)->key;
+
+		for (; i < limit; ++i)
+		{
+			if (full[depth + i] != key[depth + i])
+				return i;
+		}
+	}
+
+	return i;
+}
+
+template<typename V>
+void AdaptiveRadixTree<V>::insertSorted(unsigned char* keys, Link* children, uint16_t& count, unsigned char b, Link c)
+{
+	unsigned i = 0;
+
+	while (i < count && keys[i] < b)
+	{
+		++i;
+	}
+
+	std::memmove(keys + i + 1, keys + i, count - i);
+	std::memmove(children + i + 1, children + i, (count - i) * sizeof(Link));
+
+	keys[i] = b;
+	children[i] = c;
+	++count;
+}
+
+template<typename V>
+void AdaptiveRadixTree<V>::addChild(Link* ref, Inner* n, unsigned char b, Link c)
+{
+	switch (n->type)
+	{
+	case Node4::kind:
+	{
+		Node4* m = static_cast<Node4*>(n);
+
+		if (m->count < 4)
+		{
+			insertSorted(m->keys, m->children, m->count, b, c);
+			return;
+		}
+
+		Node16* bigger = newInner<Node16>();
+
+		copyHeader(bigger, m);
+		std::memcpy(bigger->keys, m->keys, 4);
+		std::memcpy(bigger->children, m->children, 4 * sizeof(Link));
+
+		*ref = linkTo(bigger);
+		deleteInner(m);
+		addChild(ref, bigger, b, c);
+		return;
+	}
+	case Node16::kind:
+	{
+		Node16* m = static_cast<Node16*>(n);
+
+		if (m->count < 16)
+		{
+			insertSorted(m->keys, m->children, m->count, b, c);
+			return;
+		}
+
+		Node48* bigger = newInner<Node48>();
+
+		copyHeader(bigger, m);
+
+		for (unsigned i = 0; i < 16; ++i)
+		{
+			bigger->index[m->keys[i]] = static_cast<unsigned char>(i + 1);
+			bigger->children[i] = m->children[i];
+		}
+
+		*ref = linkTo(bigger);
+		deleteInner(m);
+		addChild(ref, bigger, b, c);
+		return;
+	}
+	case Node48::kind:
+	{
+		Node48* m = static_cast<Node48*>(n);
+
+		if (m->count < 48)
+		{
+			// Removals leave holes, so the first free slot.
+			unsigned slot = 0;
+
+			while (m->children[slot])
+			{
+				++slot;
+			}
+
+			m->children[slot] = c;
+			m->index[b] = static_cast<unsigned char>(slot + 1);
+			++m->count;
+			return;
+		}
+
+		Node256* bigger = newInner<Node256>();
+
+		copyHeader(bigger, m);
+
+		for (unsigned i = 0; i < 256; ++i)
+		{
+			if (m->index[i])
+				bigger->children[i] = m->children[m->index[i] - 1];
+		}
+
+		*ref = linkTo(bigger);
+		deleteInner(m);
+		addChild(ref, bigger, b, c);
+		return;
+	}
+	default:
+	{
+		Node256* m = static_cast<Node256*>(n);
+
+		m->children[b] = c;
+		++m->count;
+		return;
+	}
+	}
+}
+
+template<typename V>
+void AdaptiveRadixTree<V>::removeChild(Inner* n, unsigned char b)
+{
+	switch (n->type)
+	{
+	case Node4::kind:
+	case Node16::kind:
+	{
+		unsigned char* keys = n->type == Node4::kind ? static_cast<Node4*>(n)->keys : static_cast<Node16*>(n)->keys;
+		Link* children = n->type == Node4::kind ? static_cast<Node4*>(n)->children : static_cast<Node16*>(n)->children;
+		unsigned i = 0;
+
+		while (keys[i] != b)
+		{
+			++i;
+		}
+
+		std::memmove(keys + i, keys + i + 1, n->count - i - 1);
+		std::memmove(children + i, children + i + 1, (n->count - i - 1) * sizeof(Link));
+		--n->count;
+		break;
+	}
+	case Node48::kind:
+	{
+		Node48* m = static_cast<Node48*>(n);
+
+		m->children[m->index[b] - 1] = 0;
+		m->index[b] = 0;
+		--m->count;
+		break;
+	}
+	default:
+	{
+		Node256* m = static_cast<Node256*>(n);
+
+		m->children[b] = 0;
+		--m->count;
+		break;
+	}
+	}
+}
+
+template<typename V>
+void AdaptiveRadixTree<V>::normalize(Link* ref)
+{
+	Inner* n = asInner(*ref);
+
+	// Every inner node holds at least two things, so one is left.
+	if (n->count == 0)
+	{
+		*ref = linkTo(n->value);
+		deleteInner(n);
+		return;
+	}
+
+	if (n->count == 1 && !n->value)
+	{
+		unsigned char b;
+		Link only = firstChild(n, b);
+
+		if (!isLeaf(only))
+		{
+			// The child takes n's prefix and b in front of its own.
+			Inner* c = asInner(only);
+			unsigned char prefix[maxPrefix];
+			size_t length = std::min<size_t>(n->prefixLength, maxPrefix);
+
+			std::memcpy(prefix, n->prefix, length);
+
+			if (length < maxPrefix)
+				prefix[length++] = b;
+
+			size_t rest = std::min<size_t>(c->prefixLength, maxPrefix - length);
+
+			std::memcpy(prefix + length, c->prefix, rest);
+			std::memcpy(c->prefix, prefix, length + rest);
+			c->prefixLength += n->prefixLength + 1;
+		}
+
+		*ref = only;
+		deleteInner(n);
+		return;
+	}
+
+	// Shrink well below the size that grows, so that a key coming and
+	// going does not copy a node each time.
+	if (n->type == Node16::kind && n->count <= 3)
+	{
+		Node16* m = static_cast<Node16*>(n);
+		Node4* smaller = newInner<Node4>();
+
+		copyHeader(smaller, m);
+		std::memcpy(smaller->keys, m->keys, m->count);
+		std::memcpy(smaller->children, m->children, m->count * sizeof(Link));
+
+		*ref = linkTo(smaller);
+		deleteInner(m);
+	}
+	else if (n->type == Node48::kind && n->count <= 12)
+	{
+		Node48* m = static_cast<Node48*>(n);
+		Node16* smaller = newInner<Node16>();
+		unsigned k = 0;
+
+		copyHeader(smaller, m);
+
+		for (unsigned i = 0; i < 256; ++i)
+		{
+			if (m->index[i])
+			{
+				smaller->keys[k] = static_cast<unsigned char>(i);
+				smaller->children[k++] = m->children[m->index[i] - 1];
+			}
+		}
+
+		*ref = linkTo(smaller);
+		deleteInner(m);
+	}
+	else if (n->type == Node256::kind && n->count <= 37)
+	{
+		Node256* m = static_cast<Node256*>(n);
+		Node48* smaller = newInner<Node48>();
+		unsigned k = 0;
+
+		copyHeader(smaller, m);
+
+		for (unsigned i = 0; i < 256; ++i)
+		{
+			if (m->children[i])
+			{
+				smaller->children[k] = m->children[i];
+				smaller->index[i] = static_cast<unsigned char>(++k);
+			}
+		}
+
+		*ref = linkTo(smaller);
+		deleteInner(m);
+	}
+}
+
+template<typename V>
+bool AdaptiveRadixTree<V>::put(const std::string& key, const V& value)
+{
+	Link* ref = &root_;
+	size_t depth = 0;
+
+	while (true)
+	{
+		Link node = *ref;
+
+		if (!node)
+		{
+			*ref = linkTo(newEntry(key, value));
+			++size_;
+			return true;
+		}
+
+		if (isLeaf(node))
+		{
+			Entry* old = asLeaf(node);
+
+			if (old->key == key)
+			{
+				old->value = value;
+				return false;
+			}
+
+			// A Node4 where the two keys part, or where one ends.
+			size_t limit = std::min(old->key.size(), key.size());
+			size_t common = 0;
+
+			while (depth + common < limit && old->key[depth + common] == key[depth + common])
+			{
+				++common;
+			}
+
+			Node4* top = newInner<Node4>();
+
+			top->prefixLength = static_cast<uint32_t>(common);
+			std::memcpy(top->prefix, key.data() + depth, std::min(common, maxPrefix));
+
+			place(top, old, depth + common);
+			place(top, newEntry(key, value), depth + common);
+
+			*ref = linkTo(top);
+			++size_;
+			return true;
+		}
+
+		Inner* n = asInner(node);
+		size_t matched = matchPrefix(n, key, depth);
+
+		if (matched < n->prefixLength)
+		{
+			// Split the prefix: a Node4 with the matched part above n,
+			// which keeps what is left after the byte it hangs from.
+			const unsigned char* full = n->prefixLength <= maxPrefix ? n->prefix :
+					reinterpret_cast<const unsigned char*>(minimum(n)->key.data()) + depth;
+			Node4* top = newInner<Node4>();
+			unsigned char b = full[matched];
+			size_t rest = n->prefixLength - matched - 1;
+
+			top->prefixLength = static_cast<uint32_t>(matched);
+			std::memcpy(top->prefix, full, std::min(matched, maxPrefix));
+
+			std::memmove(n->prefix, full + matched + 1, std::min(rest, maxPrefix));
+			n->prefixLength = static_cast<uint32_t>(rest);
+
+			insertSorted(top->keys, top->children, top->count, b, linkTo(n));
+			place(top, newEntry(key, value), depth + matched);
+
+			*ref = linkTo(top);
+			++size_;
+			return true;
+		}
+
+		depth += n->prefixLength;
+
+		if (depth == key.size())
+		{
+			if (n->value)
+			{
+				n->value->value = value;
+				return false;
+			}
+
+			n->value = newEntry(key, value);
+			++size_;
+			return true;
+		}
+
+		Link* next = child(n, byteAt(key, depth));
+
+		if (!next)
+		{
+			addChild(ref, n, byteAt(key, depth), linkTo(newEntry(key, value)));
+			++size_;
+			return true;
+		}
+
+		ref = next;
+		++depth;
+	}
+}
+
+template<typename V>
+bool AdaptiveRadixTree<V>::erase(const std::string& key)
+{
+	Link* ref = &root_;
+	Link* parent = nullptr;
+	unsigned char b = 0;
+	size_t depth = 0;
+
+	while (*ref)
+	{
+		if (isLeaf(*ref))
+		{
+			Entry* e = asLeaf(*ref);
+
+			if (e->key != key)
+				return false;
+
+			if (parent)
+			{
+				removeChild(asInner(*parent), b);
+				normalize(parent);
+			}
+			else
+			{
+				root_ = 0;
+			}
+
+			deleteEntry(e);
+			--size_;
+			return true;
+		}
+
+		Inner* n = asInner(*ref);
+
+		if (key.size() - depth < n->prefixLength ||
+				std::memcmp(n->prefix, key.data() + depth, std::min<size_t>(n->prefixLength, maxPrefix)) != 0)
+			return false;
+
+		depth += n->prefixLength;
+
+		if (depth == key.size())
+		{
+			if (!n->value || n->value->key != key)
+				return false;
+
+			deleteEntry(n->value);
+			n->value = nullptr;
+			normalize(ref);
+			--size_;
+			return true;
+		}
+
+		Link* next = child(n, byteAt(key, depth));
+
+		if (!next)
+			return false;
+
+		parent = ref;
+		b = byteAt(key, depth);
+		ref = next;
+		++depth;
+	}
+
+	return false;
+}
+
+template<typename V>
+void AdaptiveRadixTree<V>::clear()
+{
+	std::vector<Link> pending;
+
+	if (root_)
+		pending.push_back(root_);
+
+	while (!pending.empty())
+	{
+		Link node = pending.back();
+		pending.pop_back();
+
+		if (isLeaf(node))
+		{
+			deleteEntry(asLeaf(node));
+			continue;
+		}
+
+		Inner* n = asInner(node);
+
+		if (n->value)
+			deleteEntry(n->value);
+
+		forEachChild(n, [&pending](unsigned char, Link c) { pending.push_back(c); });
+		deleteInner(n);
+	}
+
+	root_ = 0;
+	size_ = 0;
+}
+
+template<typename V>
+typename AdaptiveRadixTree<V>::Entry* AdaptiveRadixTree<V>::lookup(const std::string& key) const
+{
+	Link node = root_;
+	size_t depth = 0;
+
+	while (node)
+	{
+		// The entry has the whole key, which also checks the bytes of
+		// long prefixes skipped on the way.
+		if (isLeaf(node))
+		{
+			Entry* e = asLeaf(node);
+
+			return e->key == key ? e : nullptr;
+		}
+
+		Inner* n = asInner(node);
+
+		if (key.size() - depth < n->prefixLength ||
+				std::memcmp(n->prefix, key.data() + depth, std::min<size_t>(n->prefixLength, maxPrefix)) != 0)
+			return nullptr;
+
+		depth += n->prefixLength;
+
+		if (depth == key.size())
+			return n->value && n->value->key == key ? n->value : nullptr;
+
+		Link* next = child(n, byteAt(key, depth));
+
+		if (!next)
+			return nullptr;
+
+		node = *next;
+		++depth;
+	}
+
+	return nullptr;
+}
+
+template<typename V>
+template<typename F>
+void AdaptiveRadixTree<V>::walk(Link top, F& f) const
+{
+	std::vector<Link> pending;
+	Link children[256];
+
+	if (top)
+		pending.push_back(top);
+
+	while (!pending.empty())
+	{
+		Link node = pending.back();
+		pending.pop_back();
+
+		if (isLeaf(node))
+		{
+			const Entry* e = asLeaf(node);
+
+			f(e->key, e->value);
+			continue;
+		}
+
+		// The key ending here is shorter than those below, so first.
+		Inner* n = asInner(node);
+		size_t count = 0;
+
+		if (n->value)
+			f(n->value->key, n->value->value);
+
+		forEachChild(n, [&children, &count](unsigned char, Link c) { children[count++] = c; });
+
+		while (count)
+		{
+			pending.push_back(children[--count]);
+		}
+	}
+}
+
+template<typename V>
+template<typename F>
+void AdaptiveRadixTree<V>::forEachPrefix(const std::string& prefix, F f) const
+{
+	Link node = root_;
+	size_t depth = 0;
+
+	while (node)
+	{
+		if (isLeaf(node))
+		{
+			const Entry* e = asLeaf(node);
+
+			if (startsWith(e->key, prefix))
+				f(e->key, e->value);
+
+			return;
+		}
+
+		Inner* n = asInner(node);
+
+		// prefix runs out within n's prefix: all of n or none of it.
+		if (depth + n->prefixLength >= prefix.size())
+		{
+			if (startsWith(minimum(n)->key, prefix))
+				walk(node, f);
+
+			return;
+		}
+
+		if (std::memcmp(n->prefix, prefix.data() + depth, std::min<size_t>(n->prefixLength, maxPrefix)) != 0)
+			return;
+
+		depth += n->prefixLength;
+
+		Link* next = child(n, byteAt(prefix, depth));
+
+		if (!next)
+			return;
+
+		node = *next;
+		++depth;
+	}
+}
+
+template<typename V>
+const typename AdaptiveRadixTree<V>::Entry* AdaptiveRadixTree<V>::longestPrefix(const std::string& key) const
+{
+	const Entry* best = nullptr;
+	Link node = root_;
+	size_t depth = 0;
+
+	while (node)
+	{
+		if (isLeaf(node))
+		{
+			const Entry* e = asLeaf(node);
+
+			return startsWith(key, e->key) ? e : best;
+		}
+
+		// Prefixes are matched in full here, so the path is exactly
+		// key's and every entry met on it is a prefix of key.
+		Inner* n = asInner(node);
+
+		if (matchPrefix(n, key, depth) < n->prefixLength)
+			return best;
+
+		depth += n->prefixLength;
+
+		if (n->value)
+			best = n->value;
+
+		if (depth == key.size())
+			return best;
+
+		Link* next = child(n, byteAt(key, depth));
+
+		if (!next)
+			return best;
+
+		node = *next;
+		++depth;
+	}
+
+	return best;
+}
+
+#endif
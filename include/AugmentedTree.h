@@ -0,0 +1,274 @@
+#ifndef AUGMENTEDTREE_H
+#define AUGMENTEDTREE_H
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <utility>
+
+#include "Node.h"
+#include "NodePool.h"
+#include "Hash.h"
+
+// What an AugmentedTree node holds: the key, the summary of its
+// subtree and the treap priority.
+template<typename T, typename S>
+struct AugmentedEntry
+{
+	T key;
+	S summary;
+	uint64_t priority;
+};
+
+// A search tree in which every node carries a summary of its subtree,
+// e.g. a count, a sum or a max. Augment says how a summary is made:
+//
+//	struct Augment
+//	{
+//		typedef ... value_type;
+//
+//		// left and right are nullptr for a missing child.
+//		static value_type summarize(const T& key, const value_type* left,
+//										const value_type* right);
+//	};
+//
+// Summaries are redone bottom up wherever the shape changes: along the
+// insert and erase paths and at every rotation. The tree is a treap,
+// i.e. a BST whose priorities form a heap, which keeps it balanced in
+// expectation. Priorities are a hash of a counter, so a run is
+// repeatable.
+//
+// Keys are ordered by operator<; equal keys are kept, in no order.
+template<typename T, typename Augment>
+class AugmentedTree
+{
+public:
+	typedef typename Augment::value_type Summary;
+	typedef AugmentedEntry<T, Summary> Entry;
+
+	AugmentedTree()
+		: root_(nullptr), size_(0), counter_(0)
+	{	}
+
+	// Bulk build: sorts the keys and links them into a balanced tree,
+	// summaries included, in O(n log n) with no rotations.
+	template<typename InputIt>
+	AugmentedTree(InputIt first, InputIt last);
+
+	AugmentedTree(const AugmentedTree&) = delete;
+	AugmentedTree& operator=(const AugmentedTree&) = delete;
+
+	AugmentedTree(AugmentedTree&& t)
+		: pool_(std::move(t.pool_)), root_(t.root_), size_(t.size_), counter_(t.counter_)
+	{
+		t.root_ = nullptr;
+		t.size_ = 0;
+	}
+
+	AugmentedTree& operator=(AugmentedTree&& t)
+	{
+		if (this != &t)
+		{
+			pool_ = std::move(t.pool_);
+			root_ = t.root_;
+			size_ = t.size_;
+			counter_ = t.counter_;
+			t.root_ = nullptr;
+			t.size_ = 0;
+		}
+
+		return *this;
+	}
+
+	void insert(const T& key);
+
+	// Removes one key equal to key; false if there is none.
+	bool erase(const T& key);
+
+	size_t size() const
+	{
+		return size_;
+	}
+
+	size_t height() const
+	{
+		return height(root_);
+	}
+
+	// For queries that walk the tree and prune with the summaries.
+	const Node<Entry>* root() const
+	{
+		return root_;
+	}
+
+private:
+	typedef Node<Entry> N;
+
+	static const Summary* summary(const N* node)
+	{
+		return node ? &node->data.summary : nullptr;
+	}
+
+	static void update(N* node)
+	{
+		node->data.summary = Augment::summarize(node->data.key, summary(node->left), summary(node->right));
+	}
+
+	// The child comes up; both summaries are redone, lower node first.
+	static N* rotateRight(N* node)
+	{
+		N* left = node->left;
+
+		node->left = left->right;
+		left->right = node;
+
+		update(node);
+		update(left);
+
+		return left;
+	}
+
+	static N* rotateLeft(N* node)
+	{
+		N* right = node->right;
+
+		node->right = right->left;
+		right->left = node;
+
+		update(node);
+		update(right);
+
+		return right;
+	}
+
+	N* insert(N* node, N* fresh);
+
+	// Links keys [first, last) into a balanced tree. Priorities go down
+	// with depth so that the heap order holds.
+	N* link(const T* first, const T* last, uint64_t priority);
+
+	static size_t height(const N* node)
+	{
+		return node ? 1 + std::max(height(node->left), height(node->right)) : 0;
+	}
+
+	NodePool<Entry> pool_;
+	N* root_;
+	size_t size_;
+	uint64_t counter_;
+};
+
+template<typename T, typename Augment>
+template<typename InputIt>
+AugmentedTree<T, Augment>::AugmentedTree(InputIt first, InputIt last)
+	: root_(nullptr), size_(0), counter_(0)
+{
+	std::vector<T> keys(first, last);
+
+	std::sort(keys.begin(), keys.end());
+
+	size_ = keys.size();
+	root_ = link(keys.data(), keys.data() + keys.size(), ~uint64_t(0));
+}
+
+template<typename T, typename Augment>
+void AugmentedTree<T, Augment>::insert(const T& key)
+{
+	N* fresh = pool_.create(Entry{ key, Summary(), mix64(++counter_) });
+
+	update(fresh);
+	root_ = insert(root_, fresh);
+	++size_;
+}
+
+template<typename T, typename Augment>
+typename AugmentedTree<T, Augment>::N* AugmentedTree<T, Augment>::insert(N* node, N* fresh)
+{
+	if (!node)
+		return fresh;
+
+	if (fresh->data.key < node->data.key)
+	{
+		node->left = insert(node->left, fresh);
+
+		if (node->data.priority < node->left->data.priority)
+			return rotateRight(node);
+	}
+	else
+	{
+		node->right = insert(node->right, fresh);
+
+		if (node->data.priority < node->right->data.priority)
+			return rotateLeft(node);
+	}
+
+	update(node);
+	return node;
+}
+
+template<typename T, typename Augment>
+bool AugmentedTree<T, Augment>::erase(const T& key)
+{
+	// The path down, to redo the summaries on the way back.
+	std::vector<N**> path;
+	N** link = &root_;
+
+	while (*link && ((*link)->data.key < key || key < (*link)->data.key))
+	{
+		path.push_back(link);
+		link = key < (*link)->data.key ? &(*link)->left : &(*link)->right;
+	}
+
+	N* node = *link;
+
+	if (!node)
+		return false;
+
+	// Rotate node down, the child with the higher priority coming up,
+	// until it has at most one child.
+	while (node->left && node->right)
+	{
+		path.push_back(link);
+
+		if (node->right->data.priority < node->left->data.priority)
+		{
+			*link = rotateRight(node);
+			link = &(*link)->right;
+		}
+		else
+		{
+			*link = rotateLeft(node);
+			link = &(*link)->left;
+		}
+	}
+
+	*link = node->left ? node->left : node->right;
+	pool_.destroy(node);
+	--size_;
+
+	for (auto it = path.rbegin(); it != path.rend(); ++it)
+	{
+		update(**it);
+	}
+
+	return true;
+}
+
+template<typename T, typename Augment>
+typename AugmentedTree<T, Augment>::N* AugmentedTree<T, Augment>::link(const T* first, const T* last, uint64_t priority)
+{
+	if (first == last)
+		return nullptr;
+
+	const T* mid = first + (last - first) / 2;
+	N* node = pool_.create(Entry{ *mid, Summary(), priority });
+
+	node->left = link(first, mid, priority - 1);
+	node->right = link(mid + 1, last, priority - 1);
+	update(node);
+
+	return node;
+}
+
+#endif
@@ -3,10 +3,10 @@
 
 #include <queue>
 #include <stack>
-#include <memory>
 #include <sstream>
 
 #include "BinaryTree.h"
+#include "TreeRange.h"
 
 // Only those algorithms that are unique to BST
 // (and not to BT) will be implemented here.
@@ -15,6 +15,7 @@ template<typename T>
 class BinarySearchTree : public BinaryTree<T>
 {
 	using BinaryTree<T>::root_;
+	using BinaryTree<T>::pool_;
 
 public:
 	explicit BinarySearchTree() :
@@ -24,9 +25,15 @@ public:
 	BinarySearchTree(std::initializer_list<T> il);
 	BinarySearchTree(std::vector<T> v);
 
+	// A balanced BST from a list that is sorted, e.g. toList() of a BST.
+	explicit BinarySearchTree(TreeList<T>&& list);
+
 	BinarySearchTree(const BinarySearchTree& t) = delete;
 	BinarySearchTree& operator=(const BinarySearchTree& t) = delete;
 
+	BinarySearchTree(BinarySearchTree&& t) = default;
+	BinarySearchTree& operator=(BinarySearchTree&& t) = default;
+
 	~BinarySearchTree() = default;
 
 	void serialize(std::ostream& preorderStream) const;
@@ -35,15 +42,72 @@ public:
 	T min() const;
 	T max() const;
 
+	bool contains(const T& data) const;
+
+	// The keys in [lo, hi] in order, found lazily. See TreeRange.h.
+	TreeRange<T> range(const T& lo, const T& hi) const;
+
+	// Number of keys in [lo, hi]. O(h + k).
+	size_t countRange(const T& lo, const T& hi) const;
+
+	// Same answers as lca(), one per pair in input order: the node
+	// where the two values' search paths part, whether or not they are
+	// in the tree. Each is an O(h) walk with no extra memory, so unlike
+	// BinaryTree::lcaBatch this needs no std::hash<T>.
+	template<typename ForwardIt>
+	std::vector<Node<T>*> lcaBatch(ForwardIt first, ForwardIt last) const;
+
+	std::vector<Node<T>*> lcaBatch(const std::vector<std::pair<T, T>>& queries) const;
+
+	// Removes the keys in [lo, hi] and returns how many there were.
+	// Cuts along the two boundary paths and drops the subtrees in
+	// between whole, without a search per key: O(h + k).
+	size_t eraseRange(const T& lo, const T& hi);
+
+	// Moves the keys >= key into the returned tree and keeps the
+	// smaller ones. Both come out balanced. O(n); nodes cannot move
+	// between pools one by one, so the smaller side is copied.
+	BinarySearchTree split(const T& key);
+
+	// Set operations in O(n + m): the nodes of both trees are listed
+	// in order, the lists combined in one pass and the result relinked
+	// balanced. The nodes are reused and a and b, which must be two
+	// different trees, are left empty. Duplicates count as in
+	// std::merge, std::set_union, etc.
+	static BinarySearchTree merge(BinarySearchTree&& a, BinarySearchTree&& b);
+	static BinarySearchTree setUnion(BinarySearchTree&& a, BinarySearchTree&& b);
+	static BinarySearchTree setIntersection(BinarySearchTree&& a, BinarySearchTree&& b);
+	static BinarySearchTree setDifference(BinarySearchTree&& a, BinarySearchTree&& b);
+
 private:
-	void insert(std::shared_ptr<Node<T>>& root, const T& data);
+	void insert(Node<T>*& root, const T& data);
+
+	T min(const Node<T>* root) const;
+	T max(const Node<T>* root) const;
+
+	// Keeps the keys of the subtree at link that are < lo (keepBelow)
+	// or > hi (keepAbove); the others go back to the pool. Returns the
+	// number dropped.
+	size_t keepBelow(Node<T>*& link, const T& lo);
+	size_t keepAbove(Node<T>*& link, const T& hi);
+
+	// Frees every node of the subtree at root. Iterative.
+	size_t destroy(Node<T>* root);
 
-	T min(std::shared_ptr<Node<T>> root) const;
-	T max(std::shared_ptr<Node<T>> root) const;
+	// Appends the nodes of the tree at root in inorder. Iterative.
+	static void collect(Node<T>* root, std::vector<Node<T>*>& nodes);
+
+	// Links nodes [first, last), in order, into a balanced tree.
+	static Node<T>* link(Node<T>* const* first, Node<T>* const* last);
+
+	// Keys only in a are kept if mine, keys only in b if theirs; of a
+	// pair of equal keys, both keeps 0, 1 or 2 (a's first).
+	static BinarySearchTree combine(BinarySearchTree&& a, BinarySearchTree&& b,
+										bool mine, bool theirs, int both);
 
 	// BinarySearchTree override the lca logic.
-	virtual std::shared_ptr<Node<T>> lca(std::shared_ptr<Node<T>> root, 
-											const T& data1, const T& data2) const override;
+	virtual Node<T>* lca(Node<T>* root, 
+							const T& data1, const T& data2) const override;
 
 private:
 
@@ -83,6 +147,323 @@ BinarySearchTree<T>::BinarySearchTree(std::vector<T> v)
 	}
 }
 
+template<typename T>
+BinarySearchTree<T>::BinarySearchTree(TreeList<T>&& list)
+	: BinaryTree<T>(std::move(list))
+{	}
+
+template<typename T>
+TreeRange<T> BinarySearchTree<T>::range(const T& lo, const T& hi) const
+{
+	return TreeRange<T>(root_, lo, hi);
+}
+
+template<typename T>
+size_t BinarySearchTree<T>::countRange(const T& lo, const T& hi) const
+{
+	TreeRange<T> keys = range(lo, hi);
+
+	return static_cast<size_t>(std::distance(keys.begin(), keys.end()));
+}
+
+template<typename T>
+size_t BinarySearchTree<T>::eraseRange(const T& lo, const T& hi)
+{
+	if (hi < lo)
+		return 0;
+
+	// Down to the top node in range. Its left subtree is < it <= hi,
+	// so only lo matters there; its right subtree is >= it >= lo.
+	Node<T>** link = &root_;
+
+	while (*link)
+	{
+		if ((*link)->data < lo)
+			link = &(*link)->right;
+		else if (hi < (*link)->data)
+			link = &(*link)->left;
+		else
+			break;
+	}
+
+	Node<T>* top = *link;
+
+	if (!top)
+		return 0;
+
+	size_t erased = keepBelow(top->left, lo) + keepAbove(top->right, hi) + 1;
+	Node<T>* left = top->left;
+	Node<T>* right = top->right;
+
+	pool_.destroy(top);
+
+	// Every key on the left is below every key on the right: hang the
+	// left part under the smallest node of the right part.
+	if (!right)
+	{
+		*link = left;
+	}
+	else
+	{
+		*link = right;
+
+		while (right->left)
+		{
+			right = right->left;
+		}
+
+		right->left = left;
+	}
+
+	return erased;
+}
+
+template<typename T>
+size_t BinarySearchTree<T>::keepBelow(Node<T>*& link, const T& lo)
+{
+	size_t dropped = 0;
+	Node<T>** current = &link;
+
+	while (*current)
+	{
+		Node<T>* node = *current;
+
+		if (node->data < lo)
+		{
+			current = &node->right;
+		}
+		else
+		{
+			// node and its right subtree are all >= lo.
+			*current = node->left;
+			node->left = nullptr;
+			dropped += destroy(node);
+		}
+	}
+
+	return dropped;
+}
+
+template<typename T>
+size_t BinarySearchTree<T>::keepAbove(Node<T>*& link, const T& hi)
+{
+	size_t dropped = 0;
+	Node<T>** current = &link;
+
+	while (*current)
+	{
+		Node<T>* node = *current;
+
+		if (hi < node->data)
+		{
+			current = &node->left;
+		}
+		else
+		{
+			// node and its left subtree are all <= hi.
+			*current = node->right;
+			node->right = nullptr;
+			dropped += destroy(node);
+		}
+	}
+
+	return dropped;
+}
+
+template<typename T>
+size_t BinarySearchTree<T>::destroy(Node<T>* root)
+{
+	size_t count = 0;
+	std::vector<Node<T>*> pending;
+
+	if (root)
+		pending.push_back(root);
+
+	while (!pending.empty())
+	{
+		Node<T>* node = pending.back();
+		pending.pop_back();
+
+		if (node->left)
+			pending.push_back(node->left);
+
+		if (node->right)
+			pending.push_back(node->right);
+
+		pool_.destroy(node);
+		++count;
+	}
+
+	return count;
+}
+
+template<typename T>
+BinarySearchTree<T> BinarySearchTree<T>::split(const T& key)
+{
+	BinarySearchTree<T> rest;
+	std::vector<Node<T>*> nodes;
+
+	collect(root_, nodes);
+
+	auto mid = std::partition_point(nodes.begin(), nodes.end(),
+									[&key](const Node<T>* node) { return node->data < key; });
+
+	if (mid - nodes.begin() < nodes.end() - mid)
+	{
+		// rest keeps the pool; the smaller keys get new nodes.
+		std::swap(pool_, rest.pool_);
+
+		for (auto it = nodes.begin(); it != mid; ++it)
+		{
+			Node<T>* old = *it;
+
+			*it = pool_.create(old->data);
+			rest.pool_.destroy(old);
+		}
+	}
+	else
+	{
+		for (auto it = mid; it != nodes.end(); ++it)
+		{
+			Node<T>* old = *it;
+
+			*it = rest.pool_.create(old->data);
+			pool_.destroy(old);
+		}
+	}
+
+	root_ = link(nodes.data(), nodes.data() + (mid - nodes.begin()));
+	rest.root_ = link(nodes.data() + (mid - nodes.begin()), nodes.data() + nodes.size());
+
+	return rest;
+}
+
+template<typename T>
+BinarySearchTree<T> BinarySearchTree<T>::merge(BinarySearchTree&& a, BinarySearchTree&& b)
+{
+	return combine(std::move(a), std::move(b), true, true, 2);
+}
+
+template<typename T>
+BinarySearchTree<T> BinarySearchTree<T>::setUnion(BinarySearchTree&& a, BinarySearchTree&& b)
+{
+	return combine(std::move(a), std::move(b), true, true, 1);
+}
+
+template<typename T>
+BinarySearchTree<T> BinarySearchTree<T>::setIntersection(BinarySearchTree&& a, BinarySearchTree&& b)
+{
+	return combine(std::move(a), std::move(b), false, false, 1);
+}
+
+template<typename T>
+BinarySearchTree<T> BinarySearchTree<T>::setDifference(BinarySearchTree&& a, BinarySearchTree&& b)
+{
+	return combine(std::move(a), std::move(b), true, false, 0);
+}
+
+template<typename T>
+void BinarySearchTree<T>::collect(Node<T>* root, std::vector<Node<T>*>& nodes)
+{
+	std::vector<Node<T>*> path;
+
+	while (root || !path.empty())
+	{
+		while (root)
+		{
+			path.push_back(root);
+			root = root->left;
+		}
+
+		root = path.back();
+		path.pop_back();
+
+		nodes.push_back(root);
+		root = root->right;
+	}
+}
+
+template<typename T>
+Node<T>* BinarySearchTree<T>::link(Node<T>* const* first, Node<T>* const* last)
+{
+	// Halving, so the recursion is only log2(n) deep. Unlike walking a
+	// list, the loads do not depend on each other.
+	if (first == last)
+		return nullptr;
+
+	Node<T>* const* mid = first + (last - first) / 2;
+	Node<T>* root = *mid;
+
+	root->left = link(first, mid);
+	root->right = link(mid + 1, last);
+
+	return root;
+}
+
+template<typename T>
+BinarySearchTree<T> BinarySearchTree<T>::combine(BinarySearchTree&& a, BinarySearchTree&& b,
+													bool mine, bool theirs, int both)
+{
+	BinarySearchTree<T> t;
+	std::vector<Node<T>*> x;
+	std::vector<Node<T>*> y;
+
+	collect(a.root_, x);
+	collect(b.root_, y);
+
+	std::swap(t.pool_, a.pool_);
+	t.pool_.splice(std::move(b.pool_));
+	b.pool_ = NodePool<T>();
+	a.root_ = nullptr;
+	b.root_ = nullptr;
+
+	// The kept nodes, in order.
+	std::vector<Node<T>*> nodes;
+	nodes.reserve(x.size() + y.size());
+
+	auto take = [&t, &nodes](Node<T>* node, bool keep)
+	{
+		if (keep)
+			nodes.push_back(node);
+		else
+			t.pool_.destroy(node);
+	};
+
+	size_t i = 0;
+	size_t j = 0;
+
+	while (i < x.size() && j < y.size())
+	{
+		if (x[i]->data < y[j]->data)
+		{
+			take(x[i++], mine);
+		}
+		else if (y[j]->data < x[i]->data)
+		{
+			take(y[j++], theirs);
+		}
+		else
+		{
+			take(x[i++], both > 0);
+			take(y[j++], both > 1);
+		}
+	}
+
+	for (; i < x.size(); ++i)
+	{
+		take(x[i], mine);
+	}
+
+	for (; j < y.size(); ++j)
+	{
+		take(y[j], theirs);
+	}
+
+	t.root_ = link(nodes.data(), nodes.data() + nodes.size());
+
+	return t;
+}
+
 template<typename T>
 void BinarySearchTree<T>::serialize(std::ostream& out) const
 {
@@ -114,16 +495,19 @@ void BinarySearchTree<T>::deserialize(std::istream& preorderStream)
 
 	if (!preorderVector.empty())
 	{
-		std::stack<std::shared_ptr<Node<T>>> s;
+		std::stack<Node<T>*> s;
 
-		std::shared_ptr<Node<T>> root = std::shared_ptr<Node<T>>(std::make_shared<Node<T>>(preorderVector[0]));
+		// Drop the nodes of the tree being replaced.
+		pool_.clear();
+
+		Node<T>* root = pool_.create(preorderVector[0]);
 
 		s.push(root);
 		root_ = root;
 
 		for (size_t i = 1; i < preorderVector.size(); ++i)
 		{
-			std::shared_ptr<Node<T>> temp;
+			Node<T>* temp = nullptr;
 
 			while (!s.empty() && preorderVector[i] > s.top()->data)
 			{
@@ -133,12 +517,12 @@ void BinarySearchTree<T>::deserialize(std::istream& preorderStream)
 
 			if (temp)
 			{
-				temp->right = std::shared_ptr<Node<T>>(std::make_shared<Node<T>>(preorderVector[i]));
+				temp->right = pool_.create(preorderVector[i]);
 				s.push(temp->right);
 			}
 			else
 			{
-				s.top()->left = std::shared_ptr<Node<T>>(std::make_shared<Node<T>>(preorderVector[i]));
+				s.top()->left = pool_.create(preorderVector[i]);
 				s.push(s.top()->left);
 			}
 		}
@@ -158,11 +542,36 @@ T BinarySearchTree<T>::max() const
 }
 
 template<typename T>
-void BinarySearchTree<T>::insert(std::shared_ptr<Node<T>>& root, const T& data)
+bool BinarySearchTree<T>::contains(const T& data) const
+{
+	const Node<T>* current = root_;
+	DS_STATS_ONLY(size_t depth = 0;)
+
+	while (current)
+	{
+		DS_STATS_ONLY(++depth;)
+
+		if (data < current->data)
+			current = current->left;
+		else if (current->data < data)
+			current = current->right;
+		else
+		{
+			DS_STATS_ONLY(this->recordSearch(depth);)
+			return true;
+		}
+	}
+
+	DS_STATS_ONLY(this->recordSearch(depth);)
+	return false;
+}
+
+template<typename T>
+void BinarySearchTree<T>::insert(Node<T>*& root, const T& data)
 {
 	if (!root)
 	{
-		root = std::shared_ptr<Node<T>>(std::make_shared<Node<T>>(data));
+		root = pool_.create(data);
 	}
 	else if (data < root->data)
 	{
@@ -175,7 +584,7 @@ void BinarySearchTree<T>::insert(std::shared_ptr<Node<T>>& root, const T& data)
 }
 
 template<typename T>
-T BinarySearchTree<T>::min(std::shared_ptr<Node<T>> root) const
+T BinarySearchTree<T>::min(const Node<T>* root) const
 {
 	while (root->left != nullptr)
 	{
@@ -186,7 +595,7 @@ T BinarySearchTree<T>::min(std::shared_ptr<Node<T>> root) const
 }
 
 template<typename T>
-T BinarySearchTree<T>::max(std::shared_ptr<Node<T>> root) const
+T BinarySearchTree<T>::max(const Node<T>* root) const
 {
 	while (root->right != nullptr)
 	{
@@ -197,7 +606,28 @@ T BinarySearchTree<T>::max(std::shared_ptr<Node<T>> root) const
 }
 
 template<typename T>
-std::shared_ptr<Node<T>> BinarySearchTree<T>::lca(std::shared_ptr<Node<T>> root, 
+template<typename ForwardIt>
+std::vector<Node<T>*> BinarySearchTree<T>::lcaBatch(ForwardIt first, ForwardIt last) const
+{
+	std::vector<Node<T>*> result;
+	result.reserve(std::distance(first, last));
+
+	for (; first != last; ++first)
+	{
+		result.push_back(lca(root_, first->first, first->second));
+	}
+
+	return result;
+}
+
+template<typename T>
+std::vector<Node<T>*> BinarySearchTree<T>::lcaBatch(const std::vector<std::pair<T, T>>& queries) const
+{
+	return lcaBatch(queries.begin(), queries.end());
+}
+
+template<typename T>
+Node<T>* BinarySearchTree<T>::lca(Node<T>* root, 
 													const T& data1, const T& data2) const
 {
 	if (!root)
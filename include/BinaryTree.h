@@ -2,12 +2,21 @@
 #define BINARYTREE_H
 
 #include <initializer_list>
+#include <vector>
+#include <algorithm>
+#include <limits>
 #include <queue>
-#include <memory>
 #include <iostream>
 #include <stack>
+#include <unordered_map>
+#include <utility>
+#include <iterator>
 
 #include "Node.h"
+#include "NodePool.h"
+#include "Stats.h"
+#include "LevelOrder.h"
+#include "TreeList.h"
 
 template<typename T>
 class BinaryTree
@@ -21,7 +30,35 @@ public:
 
 	BinaryTree(std::initializer_list<T> inList, std::initializer_list<T> preList);
 
-	~BinaryTree() = default;
+	// Rebuild a tree from two of its traversals, in O(n) time and with
+	// no recursion. Keys must be distinct. Preorder and postorder alone
+	// only pin down a full tree (every node has 0 or 2 children); for
+	// other trees a lone child comes out as a left child.
+	template<typename InIt, typename PreIt>
+	static BinaryTree fromInorderPreorder(InIt inFirst, InIt inLast, PreIt preFirst, PreIt preLast);
+
+	// Both ranges are walked backwards, hence bidirectional iterators.
+	template<typename InIt, typename PostIt>
+	static BinaryTree fromInorderPostorder(InIt inFirst, InIt inLast, PostIt postFirst, PostIt postLast);
+
+	template<typename PreIt, typename PostIt>
+	static BinaryTree fromPreorderPostorder(PreIt preFirst, PreIt preLast, PostIt postFirst, PostIt postLast);
+
+	// Nodes are owned by pool_, hence a tree can be moved but not copied.
+	BinaryTree(const BinaryTree& t) = delete;
+	BinaryTree& operator=(const BinaryTree& t) = delete;
+
+	BinaryTree(BinaryTree&& t);
+	BinaryTree& operator=(BinaryTree&& t);
+
+	// Takes over the nodes of list and links them into a height-balanced
+	// tree with the list's order as inorder. O(n) time, one pass over
+	// the list; the build recurses log2(n) deep, so it takes O(log n)
+	// stack rather than the O(1) of Day-Stout-Warren compression, which
+	// was about 3 times slower.
+	explicit BinaryTree(TreeList<T>&& list);
+
+	virtual ~BinaryTree() = default;
 
 	std::vector<T> inorder() const;
 	std::vector<T> inorderWithoutRecursion() const;
@@ -29,12 +66,40 @@ public:
 	std::vector<T> postorder() const;
 	std::vector<T> preorder() const;
 
+	// (level, node) pairs, level by level, down to at most maxLevels
+	// levels. See LevelOrder.h.
+	LevelOrder<T> levelOrder(size_t maxLevels = std::numeric_limits<size_t>::max()) const;
+
+	// One line per level, at most maxLevels lines. The stream is not
+	// flushed: callers that need the text out at once flush it.
+	void writeLevelOrder(std::ostream& out, size_t maxLevels = std::numeric_limits<size_t>::max()) const;
+	void writeSpiral(std::ostream& out, size_t maxLevels = std::numeric_limits<size_t>::max()) const;
+	void writePretty(std::ostream& out, size_t maxLevels = std::numeric_limits<size_t>::max()) const;
+
+	// The write functions on std::cout.
 	void displayLevelOrder() const;
 	void spiralOrder() const;
 
 	void displayPretty() const;
 	void displayAllPaths() const;
 
+	// Calls f(path, length) for every root-to-leaf path, path[0] being
+	// the root's key. All the calls share one buffer, so path is only
+	// valid during the call. No recursion.
+	template<typename F>
+	void forEachPath(F f) const;
+
+	// Same, but keep(path, length) is asked about every prefix first,
+	// in depth-first order; if it returns false, the subtree under the
+	// prefix's last node is skipped.
+	template<typename Keep, typename F>
+	void forEachPath(Keep keep, F f) const;
+
+	// The paths whose keys add up to sum. When every key is >= T{},
+	// nonNegative skips the subtrees whose prefix already exceeds sum.
+	template<typename F>
+	void forEachPathWithSum(const T& sum, F f, bool nonNegative = false) const;
+
 	size_t size() const;
 	size_t height() const;
 	size_t width() const;
@@ -47,61 +112,97 @@ public:
 
 	void mirror();
 
-	void toList();
+	// Relinks the nodes in place, in inorder, into a list that takes
+	// them over; the tree is left empty. O(n) time, O(1) memory.
+	TreeList<T> toList();
 
 	// Lowest Common Ancestor
-	std::shared_ptr<Node<T>> lca(const T& data1, const T& data2) const;
+	Node<T>* lca(const T& data1, const T& data2) const;
+
+	// Offline LCA for a batch of (data1, data2) pairs using Tarjan's
+	// union-find algorithm. One DFS answers all the queries in
+	// O(n + q.alpha(n)). Results are returned in input order and match
+	// BinaryTree::lca(). Values are looked up in a hash map, so T needs
+	// std::hash<T>. BinarySearchTree hides these with its own lcaBatch,
+	// which answers like its lca() when a value is not in the tree.
+	template<typename ForwardIt>
+	std::vector<Node<T>*> lcaBatch(ForwardIt first, ForwardIt last) const;
+
+	std::vector<Node<T>*> lcaBatch(const std::vector<std::pair<T, T>>& queries) const;
 
 	bool isSubTree(const BinaryTree<T>& sub);
-	bool isSubTree(const std::shared_ptr<Node<T>>& sub, const std::shared_ptr<Node<T>>& org);
+	bool isSubTree(const Node<T>* sub, const Node<T>* org);
 
 	// TODO: implement ==
-	bool identical(const std::shared_ptr<Node<T>>& sub, const std::shared_ptr<Node<T>>& org);
+	bool identical(const Node<T>* sub, const Node<T>* org);
+
+	// Node count and height always; allocation and search
+	// counters only when built with DS_STATS.
+	TreeStats stats() const;
 
 private:
 	void insert(const T& data);
 
-	std::shared_ptr<Node<T>> createBT(typename std::initializer_list<T>::iterator inStart, 
-									typename std::initializer_list<T>::iterator inEnd, 
-									typename std::initializer_list<T>::iterator& preStart);
+	// Builds from the keys in root-first order (preorder, or reversed
+	// postorder) and the matching inorder. first is the child visited
+	// first by that order, second the other one.
+	template<typename RootIt, typename InIt>
+	Node<T>* build(RootIt root, RootIt rootLast, InIt in, InIt inLast,
+					Node<T>* Node<T>::*first, Node<T>* Node<T>::*second);
 
-	void inorder(std::shared_ptr<Node<T>> root, std::vector<T>& v) const;
-	void postorder(std::shared_ptr<Node<T>> root, std::vector<T>& v) const;
-	void preorder(std::shared_ptr<Node<T>> root, std::vector<T>& v) const;
+	void inorder(const Node<T>* root, std::vector<T>& v) const;
+	void postorder(const Node<T>* root, std::vector<T>& v) const;
+	void preorder(const Node<T>* root, std::vector<T>& v) const;
 
-	void levelorder(std::queue<std::shared_ptr<Node<T>>>& q) const;
-	void displayPretty(std::queue<std::shared_ptr<Node<T>>>& q) const;
-	void displayAllPaths(std::shared_ptr<Node<T>> root, std::vector<T> v) const;
+	size_t size(const Node<T>* root) const;
+	size_t height(const Node<T>* root) const;
+	size_t width(const Node<T>* root) const;
+	size_t leafCount(const Node<T>* root) const;
 
-	size_t size(std::shared_ptr<Node<T>> root) const;
-	size_t height(std::shared_ptr<Node<T>> root) const;
-	size_t width(std::shared_ptr<Node<T>> root) const;
-	size_t leafCount(std::shared_ptr<Node<T>> root) const;
+	bool isBST(const Node<T>* root, T min, T max) const;
 
-	bool isBST(std::shared_ptr<Node<T>> root, T min, T max) const;
+	bool isSumProperty(const Node<T>* root) const;
 
-	bool isSumProperty(std::shared_ptr<Node<T>> root) const;
 
-	void increment(std::shared_ptr<Node<T>> root, const T& diff);
-	void toSumProperty(std::shared_ptr<Node<T>> root);
+	bool isBalanced(const Node<T>* root, size_t& height) const;
 
-	bool isBalanced(std::shared_ptr<Node<T>> root, size_t& height) const;
+	void mirror(Node<T>* root);
 
-	void mirror(std::shared_ptr<Node<T>> root);
+	// The tree as a vine: nodes chained through right in inorder.
+	static Node<T>* toVine(Node<T>* root, size_t& size);
 
-	void join(std::shared_ptr<Node<T>> a, std::shared_ptr<Node<T>> b);
-	std::shared_ptr<Node<T>> append(std::shared_ptr<Node<T>> a, std::shared_ptr<Node<T>> b);
-	std::shared_ptr<Node<T>> toList(std::shared_ptr<Node<T>> root);
+	// Links the next size nodes of a vine into a balanced tree, head
+	// ending up past them. Recursive, log2(size) deep.
+	static Node<T>* fromVine(Node<T>*& head, size_t size);
 
-	virtual std::shared_ptr<Node<T>> lca(std::shared_ptr<Node<T>> root, 
-											const T& data1, const T& data2) const;
+	virtual Node<T>* lca(Node<T>* root, 
+							const T& data1, const T& data2) const;
 
 protected:
-	std::shared_ptr<Node<T>> root_;
+#ifdef DS_STATS
+	// depth is the number of nodes visited by the search.
+	void recordSearch(size_t depth) const
+	{
+		++counters_.searches;
+		recordHistogram(counters_.searchDepths, depth);
+	}
+
+	mutable TreeStats counters_;
+#endif
+
+	NodePool<T> pool_;
+	Node<T>* root_;
+
+	// Flat layouts are built straight from the linked nodes.
+	template<typename U> friend class FlatBinaryTree;
+
+	// Interleaved lookups walk the nodes themselves.
+	friend class Interleaved;
 };
 
 template<typename T>
 BinaryTree<T>::BinaryTree(std::initializer_list<T> il)
+	: root_(nullptr)
 {
 	for (const auto& data : il)
 	{
@@ -111,32 +212,147 @@ BinaryTree<T>::BinaryTree(std::initializer_list<T> il)
 
 template<typename T>
 BinaryTree<T>::BinaryTree(std::initializer_list<T> inList, std::initializer_list<T> preList)
+	: root_(nullptr)
+{
+	root_ = build(preList.begin(), preList.end(), inList.begin(), inList.end(), &Node<T>::left, &Node<T>::right);
+}
+
+template<typename T>
+BinaryTree<T>::BinaryTree(BinaryTree&& t)
+	: pool_(std::move(t.pool_)), root_(t.root_)
 {
-	typename std::initializer_list<T>::iterator preStart = preList.begin();
-	root_ = createBT(inList.begin(), inList.end(), preStart);
+	DS_STATS_ONLY(counters_ = std::move(t.counters_);)
+	t.root_ = nullptr;
 }
 
 template<typename T>
-std::shared_ptr<Node<T>> BinaryTree<T>::createBT(typename std::initializer_list<T>::iterator inStart, 
-									typename std::initializer_list<T>::iterator inEnd, 
-									typename std::initializer_list<T>::iterator& preStart)
+BinaryTree<T>::BinaryTree(TreeList<T>&& list)
+	: pool_(std::move(list.pool_)), root_(nullptr)
 {
-	// Nothing in the inorder list.
-	if (inStart == inEnd)
+	root_ = fromVine(list.head_, list.size_);
+	list.reset();
+}
+
+template<typename T>
+BinaryTree<T>& BinaryTree<T>::operator=(BinaryTree&& t)
+{
+	if (this != &t)
+	{
+		DS_STATS_ONLY(counters_ = std::move(t.counters_);)
+		pool_ = std::move(t.pool_);
+		root_ = t.root_;
+		t.root_ = nullptr;
+	}
+
+	return *this;
+}
+
+template<typename T>
+template<typename InIt, typename PreIt>
+BinaryTree<T> BinaryTree<T>::fromInorderPreorder(InIt inFirst, InIt inLast, PreIt preFirst, PreIt preLast)
+{
+	BinaryTree<T> t;
+	t.root_ = t.build(preFirst, preLast, inFirst, inLast, &Node<T>::left, &Node<T>::right);
+
+	return t;
+}
+
+template<typename T>
+template<typename InIt, typename PostIt>
+BinaryTree<T> BinaryTree<T>::fromInorderPostorder(InIt inFirst, InIt inLast, PostIt postFirst, PostIt postLast)
+{
+	// Reversed, postorder is root, right, left and inorder is right,
+	// root, left: preorder with the children swapped.
+	BinaryTree<T> t;
+	t.root_ = t.build(std::reverse_iterator<PostIt>(postLast), std::reverse_iterator<PostIt>(postFirst),
+						std::reverse_iterator<InIt>(inLast), std::reverse_iterator<InIt>(inFirst),
+						&Node<T>::right, &Node<T>::left);
+
+	return t;
+}
+
+template<typename T>
+template<typename PreIt, typename PostIt>
+BinaryTree<T> BinaryTree<T>::fromPreorderPostorder(PreIt preFirst, PreIt preLast, PostIt postFirst, PostIt postLast)
+{
+	BinaryTree<T> t;
+
+	// Nodes whose subtree is not complete yet, the deepest at the back.
+	// A subtree is complete when its root comes up in postorder.
+	std::vector<Node<T>*> open;
+
+	for (; preFirst != preLast; ++preFirst)
+	{
+		Node<T>* node = t.pool_.create(*preFirst);
+
+		if (!t.root_)
+		{
+			t.root_ = node;
+		}
+		else
+		{
+			// The traversals do not match: everything is complete.
+			if (open.empty())
+				break;
+
+			Node<T>* parent = open.back();
+
+			if (!parent->left)
+				parent->left = node;
+			else
+				parent->right = node;
+		}
+
+		open.push_back(node);
+
+		while (!open.empty() && postFirst != postLast && open.back()->data == *postFirst)
+		{
+			open.pop_back();
+			++postFirst;
+		}
+	}
+
+	return t;
+}
+
+template<typename T>
+template<typename RootIt, typename InIt>
+Node<T>* BinaryTree<T>::build(RootIt root, RootIt rootLast, InIt in, InIt inLast,
+								Node<T>* Node<T>::*first, Node<T>* Node<T>::*second)
+{
+	if (root == rootLast)
 		return nullptr;
 
-	std::shared_ptr<Node<T>> temp = std::make_shared<Node<T>>(*preStart++);
+	Node<T>* top = pool_.create(*root);
 
-	// Only 1 element in the inorder list. It does not have any child.
-	if (inStart + 1 == inEnd)
-		return temp;
+	// The path from the root to the last node created, less the nodes
+	// whose first subtree is complete. A node's first subtree is
+	// complete when the node comes up in inorder.
+	std::vector<Node<T>*> path(1, top);
 
-	auto it = std::find(inStart, inEnd, temp->data);
+	for (++root; root != rootLast; ++root)
+	{
+		Node<T>* node = pool_.create(*root);
+		Node<T>* parent = nullptr;
+
+		// The deepest node whose first subtree just completed takes
+		// node as its second child.
+		while (!path.empty() && in != inLast && path.back()->data == *in)
+		{
+			parent = path.back();
+			path.pop_back();
+			++in;
+		}
+
+		if (parent)
+			parent->*second = node;
+		else
+			path.back()->*first = node;
 
-	temp->left = createBT(inStart, it, preStart);
-	temp->right = createBT(it + 1, inEnd, preStart);
+		path.push_back(node);
+	}
 
-	return temp;
+	return top;
 }
 
 template<typename T>
@@ -153,9 +369,9 @@ template<typename T>
 std::vector<T> BinaryTree<T>::inorderWithoutRecursion() const
 {
 	std::vector<T> v;
-	std::stack<std::shared_ptr<Node<T>>> s;
+	std::stack<const Node<T>*> s;
 	bool done = false;
-	std::shared_ptr<Node<T>> current = root_;
+	const Node<T>* current = root_;
 
 	while (!done)
 	{
@@ -186,7 +402,7 @@ template<typename T>
 std::vector<T> BinaryTree<T>::inorderMorris()
 {
 	std::vector<T> v;
-	std::shared_ptr<Node<T>> current = root_;
+	Node<T>* current = root_;
 
 	while (current)
 	{
@@ -197,7 +413,7 @@ std::vector<T> BinaryTree<T>::inorderMorris()
 		}
 		else
 		{
-			std::shared_ptr<Node<T>> temp = current->left;
+			Node<T>* temp = current->left;
 
 			while (temp->right && temp->right != current)
 				temp = temp->right;
@@ -240,78 +456,201 @@ std::vector<T> BinaryTree<T>::preorder() const
 }
 
 template<typename T>
-void BinaryTree<T>::displayLevelOrder() const
+LevelOrder<T> BinaryTree<T>::levelOrder(size_t maxLevels) const
 {
-	std::queue<std::shared_ptr<Node<T>>> q;
-	q.push(root_);
-	q.push(nullptr);
-
-	levelorder(q);
+	return LevelOrder<T>(root_, maxLevels);
 }
 
 template<typename T>
-void BinaryTree<T>::spiralOrder() const
+void BinaryTree<T>::writeLevelOrder(std::ostream& out, size_t maxLevels) const
 {
-	if (!root_)
-		return;
-
-	std::stack<std::shared_ptr<Node<T>>> s1;
-	std::stack<std::shared_ptr<Node<T>>> s2;
-
-	s1.push(root_);
+	size_t line = 0;
+	bool any = false;
 
-	while (!s1.empty() || !s2.empty())
+	for (auto p : levelOrder(maxLevels))
 	{
-		while (!s1.empty())
+		if (p.first != line)
 		{
-			std::shared_ptr<Node<T>> temp = s1.top();
-			s1.pop();
+			out << '\n';
+			line = p.first;
+		}
+
+		out << p.second->data << '\t';
+		any = true;
+	}
 
-			std::cout << temp->data << " ";
+	if (any)
+		out << '\n';
+}
+
+template<typename T>
+void BinaryTree<T>::writeSpiral(std::ostream& out, size_t maxLevels) const
+{
+	// Odd levels left to right, even ones right to left.
+	std::vector<const Node<T>*> row;
+	size_t line = 0;
 
-			if (temp->right)
-				s2.push(temp->right);
+	auto writeRow = [&]()
+	{
+		if (line % 2 == 0)
+			std::reverse(row.begin(), row.end());
 
-			if (temp->left)
-				s2.push(temp->left);
+		for (const Node<T>* node : row)
+		{
+			out << node->data << ' ';
 		}
 
-		std::cout << std::endl;
+		out << '\n';
+		row.clear();
+	};
 
-		while (!s2.empty())
+	for (auto p : levelOrder(maxLevels))
+	{
+		if (p.first != line)
 		{
-			std::shared_ptr<Node<T>> temp = s2.top();
-			s2.pop();
+			writeRow();
+			line = p.first;
+		}
 
-			std::cout << temp->data << " ";
+		row.push_back(p.second);
+	}
 
-			if (temp->left)
-				s1.push(temp->left);
+	if (!row.empty())
+		writeRow();
+}
 
-			if (temp->right)
-				s1.push(temp->right);
+// TODO: Works only for complete BT. Need to handle other cases.
+template<typename T>
+void BinaryTree<T>::writePretty(std::ostream& out, size_t maxLevels) const
+{
+	// Nodes of level k are spread over the width of the bottom level:
+	// the gap before a node halves with every level.
+	size_t h = 2 * height();
+	size_t line = 0;
+	size_t scale = 1;
+	bool firstNode = true;
+	bool any = false;
+
+	for (auto p : levelOrder(maxLevels))
+	{
+		if (p.first != line)
+		{
+			out << '\n';
+			line = p.first;
+			scale = scale > h ? scale : 2 * scale;
+			firstNode = true;
 		}
 
-		std::cout << std::endl;
+		size_t gap = firstNode ? h / scale : 2 * (h / scale);
+
+		if (gap > 1)
+			out << std::string(gap - 1, '-');
+
+		out << p.second->data;
+		firstNode = false;
+		any = true;
 	}
+
+	if (any)
+		out << '\n';
 }
 
+template<typename T>
+void BinaryTree<T>::displayLevelOrder() const
+{
+	writeLevelOrder(std::cout);
+}
+template<typename T>
+void BinaryTree<T>::spiralOrder() const
+{
+	writeSpiral(std::cout);
+}
 template<typename T>
 void BinaryTree<T>::displayPretty() const
 {
-	std::queue<std::shared_ptr<Node<T>>> q;
+	writePretty(std::cout);
+}
+template<typename T>
+void BinaryTree<T>::displayAllPaths() const
+{
+	forEachPath([](const T* path, size_t length)
+	{
+		for (size_t i = 0; i < length; ++i)
+		{
+			std::cout << path[i] << "\t";
+		}
 
-	q.push(root_);
-	q.push(nullptr);
+		std::cout << '\n';
+	});
+}
 
-	displayPretty(q);
+template<typename T>
+template<typename F>
+void BinaryTree<T>::forEachPath(F f) const
+{
+	forEachPath([](const T*, size_t) { return true; }, f);
 }
 
 template<typename T>
-void BinaryTree<T>::displayAllPaths() const
+template<typename Keep, typename F>
+void BinaryTree<T>::forEachPath(Keep keep, F f) const
 {
-	std::vector<T> v;
-	displayAllPaths(root_, v);
+	if (!root_)
+		return;
+
+	std::vector<T> path;
+
+	// Nodes still to visit with their depth. The path is cut back to
+	// a node's depth before its key goes on.
+	std::vector<std::pair<const Node<T>*, size_t>> pending(1, std::make_pair(root_, 0));
+
+	while (!pending.empty())
+	{
+		const Node<T>* node = pending.back().first;
+		size_t depth = pending.back().second;
+
+		pending.pop_back();
+
+		path.erase(path.begin() + depth, path.end());
+		path.push_back(node->data);
+
+		if (!keep(static_cast<const T*>(path.data()), path.size()))
+			continue;
+
+		if (!node->left && !node->right)
+		{
+			f(static_cast<const T*>(path.data()), path.size());
+			continue;
+		}
+
+		if (node->right)
+			pending.push_back(std::make_pair(node->right, depth + 1));
+
+		if (node->left)
+			pending.push_back(std::make_pair(node->left, depth + 1));
+	}
+}
+
+template<typename T>
+template<typename F>
+void BinaryTree<T>::forEachPathWithSum(const T& sum, F f, bool nonNegative) const
+{
+	// sums[i] is the sum of path[0..i]; keep sees every prefix once, in
+	// order, so it can keep sums in step with the path.
+	std::vector<T> sums;
+
+	forEachPath([&sums, &sum, nonNegative](const T* path, size_t length)
+	{
+		sums.erase(sums.begin() + (length - 1), sums.end());
+		sums.push_back(length > 1 ? sums.back() + path[length - 1] : path[0]);
+
+		return !nonNegative || !(sum < sums.back());
+	},
+	[&sums, &sum, &f](const T* path, size_t length)
+	{
+		if (sums.back() == sum)
+			f(path, length);
+	});
 }
 
 template<typename T>
@@ -354,7 +693,81 @@ bool BinaryTree<T>::isSumProperty() const
 template<typename T>
 void BinaryTree<T>::toSumProperty()
 {
-	toSumProperty(root_);
+	// Bottom up, a node less than the sum of its children is raised to
+	// it. A node greater than the sum raises its left child by the
+	// difference, and that child passes it on down its left child (or
+	// right, if it has no left), and so on to a leaf. Doing those path
+	// increments right away is O(n) each, so they are done lazily in a
+	// second, top-down pass. Keys only go up, as before.
+	if (!root_)
+		return;
+
+	// Parents before children; walked backwards, children first.
+	std::vector<Node<T>*> nodes;
+	nodes.push_back(root_);
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		if (nodes[i]->left)
+			nodes.push_back(nodes[i]->left);
+
+		if (nodes[i]->right)
+			nodes.push_back(nodes[i]->right);
+	}
+
+	// push[i] is what nodes[i] passes down its left path.
+	std::vector<T> push(nodes.size(), T{});
+
+	for (size_t i = nodes.size(); i-- > 0; )
+	{
+		Node<T>* node = nodes[i];
+
+		if (!node->left && !node->right)
+			continue;
+
+		T leftValue = {};
+		T rightValue = {};
+
+		if (node->left)
+			leftValue = node->left->data;
+
+		if (node->right)
+			rightValue = node->right->data;
+
+		T diff = node->data - (leftValue + rightValue);
+
+		if (diff < 0)
+			node->data += -diff;
+		else if (node->left)
+			push[i] = diff;
+	}
+
+	// Top down, carry[i] being what nodes[i] gets from above. The
+	// children of nodes[i] are the next ones not yet reached, as in
+	// the breadth-first walk that listed them.
+	std::vector<T> carry(nodes.size(), T{});
+	size_t next = 1;
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		Node<T>* node = nodes[i];
+
+		// Its own push and what it got go to its left child, or what
+		// it got to its right child if it has no left.
+		if (node->left)
+		{
+			carry[next++] = carry[i] + push[i];
+
+			if (node->right)
+				++next;
+		}
+		else if (node->right)
+		{
+			carry[next++] = carry[i];
+		}
+
+		node->data += carry[i];
+	}
 }
 
 template<typename T>
@@ -371,43 +784,227 @@ void BinaryTree<T>::mirror()
 }
 
 template<typename T>
-void BinaryTree<T>::toList()
+TreeList<T> BinaryTree<T>::toList()
 {
-	std::shared_ptr<Node<T>> head = toList(root_);
-	std::shared_ptr<Node<T>> start = nullptr;
+	TreeList<T> list;
+
+	list.head_ = toVine(root_, list.size_);
 
-	bool first = true;
+	// Fill in the back links.
+	Node<T>* prev = nullptr;
 
-	while (head)
+	for (Node<T>* node = list.head_; node; node = node->right)
 	{
-		if (first)
+		node->left = prev;
+		prev = node;
+	}
+
+	list.tail_ = prev;
+	list.pool_ = std::move(pool_);
+	pool_ = NodePool<T>();
+	root_ = nullptr;
+
+	return list;
+}
+
+template<typename T>
+Node<T>* BinaryTree<T>::lca(const T& data1, const T& data2) const
+{
+	return lca(root_, data1, data2);
+}
+
+template<typename T>
+template<typename ForwardIt>
+std::vector<Node<T>*> BinaryTree<T>::lcaBatch(ForwardIt first, ForwardIt last) const
+{
+	const size_t none = static_cast<size_t>(-1);
+	const size_t q = std::distance(first, last);
+
+	std::vector<Node<T>*> result(q);
+
+	if (!root_ || q == 0)
+		return result;
+
+	// Number the nodes in preorder. A value that occurs more than once
+	// is represented by its first node in preorder.
+	std::vector<Node<T>*> nodes;
+	std::vector<size_t> leftChild;
+	std::vector<size_t> rightChild;
+	std::unordered_map<T, size_t> index;
+
+	// In preorder the left child of u is always u + 1. The right child
+	// is only known once it is popped, so its stack entry carries the
+	// index of the parent.
+	std::stack<std::pair<Node<T>*, size_t>> s;
+	s.push(std::make_pair(root_, none));
+
+	while (!s.empty())
+	{
+		Node<T>* temp = s.top().first;
+		size_t p = s.top().second;
+		s.pop();
+
+		size_t u = nodes.size();
+
+		if (p != none)
+			rightChild[p] = u;
+
+		index.insert(std::make_pair(temp->data, u));
+		nodes.push_back(temp);
+		leftChild.push_back(temp->left ? u + 1 : none);
+		rightChild.push_back(none);
+
+		if (temp->right)
+			s.push(std::make_pair(temp->right, u));
+
+		if (temp->left)
+			s.push(std::make_pair(temp->left, none));
+	}
+
+	const size_t n = nodes.size();
+
+	// Resolve every query to node indices and bucket the queries by node
+	// (CSR layout) so that no allocation happens per query.
+	std::vector<size_t> qa(q);
+	std::vector<size_t> qb(q);
+	std::vector<size_t> offset(n + 1, 0);
+
+	size_t i = 0;
+
+	for (ForwardIt it = first; it != last; ++it, ++i)
+	{
+		auto a = index.find(it->first);
+		auto b = index.find(it->second);
+
+		qa[i] = (a == index.end()) ? none : a->second;
+		qb[i] = (b == index.end()) ? none : b->second;
+
+		// Same answer as lca(): a value missing from the tree
+		// yields the node of the other one (or nullptr).
+		if (qa[i] == none || qb[i] == none)
 		{
-			first = false;
-			start = head;
+			if (qa[i] != none)
+				result[i] = nodes[qa[i]];
+			else if (qb[i] != none)
+				result[i] = nodes[qb[i]];
+
+			continue;
 		}
-		else
+
+		++offset[qa[i] + 1];
+		++offset[qb[i] + 1];
+	}
+
+	for (size_t u = 0; u < n; ++u)
+		offset[u + 1] += offset[u];
+
+	std::vector<size_t> bucket(offset[n]);
+	std::vector<size_t> fill(offset.begin(), offset.end() - 1);
+
+	for (i = 0; i < q; ++i)
+	{
+		if (qa[i] == none || qb[i] == none)
+			continue;
+
+		bucket[fill[qa[i]]++] = i;
+		bucket[fill[qb[i]]++] = i;
+	}
+
+	// Tarjan's algorithm. set[] is the union-find forest, ancestor[] the
+	// current ancestor of each set's representative.
+	std::vector<size_t> set(n);
+	std::vector<size_t> ancestor(n);
+	std::vector<bool> done(n, false);
+
+	auto find = [&set](size_t u)
+	{
+		size_t r = u;
+
+		while (set[r] != r)
+			r = set[r];
+
+		// Path compression.
+		while (set[u] != r)
+		{
+			size_t next = set[u];
+			set[u] = r;
+			u = next;
+		}
+
+		return r;
+	};
+
+	// Iterative postorder walk. The second member tells which child
+	// is to be visited next (0 - left, 1 - right, 2 - finished).
+	std::vector<std::pair<size_t, int>> path;
+
+	path.push_back(std::make_pair(0, 0));
+	set[0] = 0;
+	ancestor[0] = 0;
+
+	while (!path.empty())
+	{
+		size_t u = path.back().first;
+		int& state = path.back().second;
+
+		if (state < 2)
 		{
-			// Its a circular list. Need to stop after first scan.
-			if (start == head)
+			size_t v = (state == 0) ? leftChild[u] : rightChild[u];
+			++state;
+
+			if (v != none)
 			{
-				break;
+				set[v] = v;
+				ancestor[v] = v;
+				path.push_back(std::make_pair(v, 0));
 			}
+
+			continue;
 		}
 
-		std::cout << head->data << "\t";
+		done[u] = true;
 
-		// Its a circular list. Classic case for shared_ptr to leak memory.
-		std::shared_ptr<Node<T>> temp = head->right;
-		head->left = nullptr;
-		head->right = nullptr;
-		head = temp;
+		for (size_t k = offset[u]; k < offset[u + 1]; ++k)
+		{
+			size_t id = bucket[k];
+			size_t v = (qa[id] == u) ? qb[id] : qa[id];
+
+			if (done[v])
+				result[id] = nodes[ancestor[find(v)]];
+		}
+
+		path.pop_back();
+
+		if (!path.empty())
+		{
+			size_t p = path.back().first;
+			set[find(u)] = find(p);
+			ancestor[find(p)] = p;
+		}
 	}
+
+	return result;
 }
 
 template<typename T>
-std::shared_ptr<Node<T>> BinaryTree<T>::lca(const T& data1, const T& data2) const
+std::vector<Node<T>*> BinaryTree<T>::lcaBatch(const std::vector<std::pair<T, T>>& queries) const
 {
-	return lca(root_, data1, data2);
+	return lcaBatch(queries.begin(), queries.end());
+}
+
+template<typename T>
+TreeStats BinaryTree<T>::stats() const
+{
+	TreeStats s;
+
+#ifdef DS_STATS
+	s = counters_;
+#endif
+
+	pool_.stats(s);
+	s.height = height();
+
+	return s;
 }
 
 /////////// Private Member Functions ///////////
@@ -417,23 +1014,23 @@ void BinaryTree<T>::insert(const T& data)
 {
 	if (!root_)
 	{
-		root_ = std::make_shared<Node<T>>(data);
+		root_ = pool_.create(data);
 		return;
 	}
 
-	std::queue<std::shared_ptr<Node<T>>> q;
+	std::queue<Node<T>*> q;
 	q.push(root_);
 
 	while (!q.empty())
 	{				
-		std::shared_ptr<Node<T>> temp = q.front();
+		Node<T>* temp = q.front();
 		q.pop();
 
 		if (temp)
 		{
 			if (!temp->left)
 			{
-				temp->left = std::make_shared<Node<T>>(data);
+				temp->left = pool_.create(data);
 				break;
 			}
 			else
@@ -443,7 +1040,7 @@ void BinaryTree<T>::insert(const T& data)
 
 			if (!temp->right)
 			{
-				temp->right = std::make_shared<Node<T>>(data);
+				temp->right = pool_.create(data);
 				break;
 			}
 			else
@@ -455,7 +1052,7 @@ void BinaryTree<T>::insert(const T& data)
 }
 
 template<typename T>
-void BinaryTree<T>::inorder(std::shared_ptr<Node<T>> root, std::vector<T>& v) const
+void BinaryTree<T>::inorder(const Node<T>* root, std::vector<T>& v) const
 {
 	if (root != nullptr)
 	{
@@ -468,7 +1065,7 @@ void BinaryTree<T>::inorder(std::shared_ptr<Node<T>> root, std::vector<T>& v) co
 }
 
 template<typename T>
-void BinaryTree<T>::postorder(std::shared_ptr<Node<T>> root, std::vector<T>& v) const
+void BinaryTree<T>::postorder(const Node<T>* root, std::vector<T>& v) const
 {
 	if (root != nullptr)
 	{
@@ -480,7 +1077,7 @@ void BinaryTree<T>::postorder(std::shared_ptr<Node<T>> root, std::vector<T>& v)
 }
 
 template<typename T>
-void BinaryTree<T>::preorder(std::shared_ptr<Node<T>> root, std::vector<T>& v) const
+void BinaryTree<T>::preorder(const Node<T>* root, std::vector<T>& v) const
 {
 	if (root != nullptr)
 	{
@@ -492,141 +1089,7 @@ void BinaryTree<T>::preorder(std::shared_ptr<Node<T>> root, std::vector<T>& v) c
 }
 
 template<typename T>
-void BinaryTree<T>::levelorder(std::queue<std::shared_ptr<Node<T>>>& q) const
-{
-	while (!q.empty())
-	{
-		std::shared_ptr<Node<T>> temp = q.front();
-		q.pop();
-
-		if (temp)
-		{
-			std::cout << temp->data << "\t";
-
-			if (temp->left)
-			{
-				q.push(temp->left);
-			}
-
-			if (temp->right)
-			{
-				q.push(temp->right);
-			}
-
-			if (!q.front())
-			{
-				q.pop();
-				std::cout << std::endl;
-				q.push(nullptr);
-			}
-		}
-	}
-}
-
-// TODO: Works only for complete BT. Need to handle other cases.
-template<typename T>
-void BinaryTree<T>::displayPretty(std::queue<std::shared_ptr<Node<T>>>& q) const
-{
-	size_t h = 2 * height(q.front());
-	size_t level = 1;
-	bool firstNode = true;
-	char space = '-';
-
-	while (!q.empty())
-	{
-		std::shared_ptr<Node<T>> temp = q.front();
-		q.pop();
-
-		if (temp)
-		{
-			if (firstNode)
-			{
-				for (int i = 1; i < h / level; ++i)
-				{
-					std::cout << space;
-				}
-
-				firstNode = false;
-				std::cout << temp->data;
-			}
-			else
-			{
-				for (int i = 1; i < 2 * (h / level); ++i)
-				{
-					std::cout << space;
-				}
-
-				std::cout << temp->data;
-			}
-
-			if (temp->left)
-			{
-				q.push(temp->left);
-			}
-			else
-			{
-				//q.push(std::make_shared<Node<T>>(T{}));
-			}
-
-			if (temp->right)
-			{
-				q.push(temp->right);
-			}
-			else
-			{
-				//q.push(std::make_shared<Node<T>>(T{}));
-			}
-
-			if (!q.front())
-			{
-				q.pop();
-				std::cout << std::endl;
-				q.push(nullptr);
-
-				firstNode = true;
-				level *= 2;
-			}
-		}
-	}
-}
-
-template<typename T>
-void BinaryTree<T>::displayAllPaths(std::shared_ptr<Node<T>> root,
-					std::vector<T> v) const
-{
-	// 4 parts of recursion:
-
-	// 1. termination condition
-	if (!root)
-	{
-		return;
-	}
-
-	// 2. some task to perform
-	v.push_back(root->data);
-
-	// 3. generate result
-	// condition when to generate result can be
-	// different from termination condition.
-	if (!root->left && !root->right)
-	{
-		for (const auto& ele : v)
-		{
-			std::cout << ele << "\t";
-		}
-
-		std::cout << std::endl;
-		
-		return;
-	}
-
-	// 4. recursion call(s)
-	displayAllPaths(root->left, v);
-	displayAllPaths(root->right, v);
-}
-
-template<typename T>
-size_t BinaryTree<T>::size(std::shared_ptr<Node<T>> root) const
+size_t BinaryTree<T>::size(const Node<T>* root) const
 {
 	if (root)
 	{
@@ -639,7 +1102,7 @@ size_t BinaryTree<T>::size(std::shared_ptr<Node<T>> root) const
 }
 
 template<typename T>
-size_t BinaryTree<T>::height(std::shared_ptr<Node<T>> root) const
+size_t BinaryTree<T>::height(const Node<T>* root) const
 {
 	if (!root)
 	{
@@ -650,7 +1113,7 @@ size_t BinaryTree<T>::height(std::shared_ptr<Node<T>> root) const
 }
 
 template<typename T>
-size_t BinaryTree<T>::width(std::shared_ptr<Node<T>> root) const
+size_t BinaryTree<T>::width(const Node<T>* root) const
 {
 	if (!root)
 	{
@@ -668,7 +1131,7 @@ size_t BinaryTree<T>::width(std::shared_ptr<Node<T>> root) const
 }
 
 template<typename T>
-size_t BinaryTree<T>::leafCount(std::shared_ptr<Node<T>> root) const
+size_t BinaryTree<T>::leafCount(const Node<T>* root) const
 {
 	if (!root)
 		return 0;
@@ -680,7 +1143,7 @@ size_t BinaryTree<T>::leafCount(std::shared_ptr<Node<T>> root) const
 }
 
 template<typename T>
-bool BinaryTree<T>::isBST(std::shared_ptr<Node<T>> root, T min, T max) const
+bool BinaryTree<T>::isBST(const Node<T>* root, T min, T max) const
 {
 	if (!root)
 		return true;
@@ -693,7 +1156,7 @@ bool BinaryTree<T>::isBST(std::shared_ptr<Node<T>> root, T min, T max) const
 }
 
 template<typename T>
-bool BinaryTree<T>::isSumProperty(std::shared_ptr<Node<T>> root) const
+bool BinaryTree<T>::isSumProperty(const Node<T>* root) const
 {
 	if (!root)
 		return true;
@@ -716,54 +1179,7 @@ bool BinaryTree<T>::isSumProperty(std::shared_ptr<Node<T>> root) const
 }
 
 template<typename T>
-void BinaryTree<T>::increment(std::shared_ptr<Node<T>> root, const T& diff)
-{
-	if (!root)
-		return;
-
-	root->data += diff;
-
-	if (root->left)
-		increment(root->left, diff);
-	else
-		increment(root->right, diff);
-}
-
-template<typename T>
-void BinaryTree<T>::toSumProperty(std::shared_ptr<Node<T>> root)
-{
-	if (!root)
-		return;
-
-	if (!root->left && !root->right)
-		return;
-
-	toSumProperty(root->left);
-	toSumProperty(root->right);
-
-	T leftValue = {};
-	T rightValue = {};
-
-	if (root->left)
-		leftValue = root->left->data;
-
-	if (root->right)
-		rightValue = root->right->data;
-
-	T diff = root->data - (leftValue + rightValue);
-
-	if (!diff)
-		return;
-
-	if (diff < 0)
-		root->data += -diff;
-
-	if (diff > 0)
-		increment(root->left, diff);
-}
-
-template<typename T>
-bool BinaryTree<T>::isBalanced(std::shared_ptr<Node<T>> root, size_t& height) const
+bool BinaryTree<T>::isBalanced(const Node<T>* root, size_t& height) const
 {
 	if (!root)
 	{
@@ -779,12 +1195,15 @@ bool BinaryTree<T>::isBalanced(std::shared_ptr<Node<T>> root, size_t& height) co
 
 	height = std::max(leftHeight, rightHeight) + 1;
 
-	return (std::abs(leftHeight - rightHeight) < 2) && 
+	size_t diff = leftHeight > rightHeight ? leftHeight - rightHeight
+											: rightHeight - leftHeight;
+
+	return (diff < 2) && 
 			isLeftBalanced && isRightBalanced;
 }
 
 template<typename T>
-void BinaryTree<T>::mirror(std::shared_ptr<Node<T>> root)
+void BinaryTree<T>::mirror(Node<T>* root)
 {
 	// 3 parts of recursion:
 
@@ -799,60 +1218,60 @@ void BinaryTree<T>::mirror(std::shared_ptr<Node<T>> root)
 	mirror(root->right);
 
 	// 3. some task to perform
-	std::shared_ptr<Node<T>> temp = root->right;
+	Node<T>* temp = root->right;
 	root->right = root->left;
 	root->left = temp;
 }
 
 template<typename T>
-void BinaryTree<T>::join(std::shared_ptr<Node<T>> a, 
-										std::shared_ptr<Node<T>> b)
-{
-	a->right = b;
-	b->left = a;
-}
-
-template<typename T>
-std::shared_ptr<Node<T>> BinaryTree<T>::append(std::shared_ptr<Node<T>> a, 
-										std::shared_ptr<Node<T>> b)
+Node<T>* BinaryTree<T>::toVine(Node<T>* root, size_t& size)
 {
-	if (!a)
-		return b;
+	size = 0;
 
-	if (!b)
-		return a;
+	// Rotate right at each node with a left child until it has none,
+	// then move on down the right spine.
+	for (Node<T>** link = &root; *link; )
+	{
+		Node<T>* node = *link;
 
-	std::shared_ptr<Node<T>> aLast = a->left;
-	std::shared_ptr<Node<T>> bLast = b->left;
+		if (node->left)
+		{
+			Node<T>* left = node->left;
 
-	join(aLast, b);
-	join(bLast, a);
+			node->left = left->right;
+			left->right = node;
+			*link = left;
+		}
+		else
+		{
+			++size;
+			link = &node->right;
+		}
+	}
 
-	return a;
+	return root;
 }
 
 template<typename T>
-std::shared_ptr<Node<T>> BinaryTree<T>::toList(std::shared_ptr<Node<T>> root)
+Node<T>* BinaryTree<T>::fromVine(Node<T>*& head, size_t size)
 {
-	if (!root)
-	{
+	// One pass down the vine, so each node is touched once: the
+	// recursion only goes log2(size) deep.
+	if (size == 0)
 		return nullptr;
-	}
-
-	std::shared_ptr<Node<T>> aList = toList(root->left);
-	std::shared_ptr<Node<T>> bList = toList(root->right);
 
-	root->left = root;
-	root->right = root;
+	Node<T>* left = fromVine(head, size / 2);
+	Node<T>* root = head;
 
-	std::shared_ptr<Node<T>> temp1 = append(aList, root);
-	std::shared_ptr<Node<T>> temp2 = append(temp1, bList);
+	head = head->right;
+	root->left = left;
+	root->right = fromVine(head, size - 1 - size / 2);
 
-	return temp2;
+	return root;
 }
 
 template<typename T>
-std::shared_ptr<Node<T>> BinaryTree<T>::lca(std::shared_ptr<Node<T>> root, 
+Node<T>* BinaryTree<T>::lca(Node<T>* root, 
 												const T& data1, const T& data2) const
 {
 	if (!root)
@@ -865,8 +1284,8 @@ std::shared_ptr<Node<T>> BinaryTree<T>::lca(std::shared_ptr<Node<T>> root,
 		return root;
 	}
 
-	std::shared_ptr<Node<T>> lca1 = lca(root->left, data1, data2);
-	std::shared_ptr<Node<T>> lca2 = lca(root->right, data1, data2);
+	Node<T>* lca1 = lca(root->left, data1, data2);
+	Node<T>* lca2 = lca(root->right, data1, data2);
 
 	if (lca1 && lca2)
 	{
@@ -883,8 +1302,8 @@ bool BinaryTree<T>::isSubTree(const BinaryTree<T>& sub)
 }
 
 template<typename T>
-bool BinaryTree<T>::isSubTree(const std::shared_ptr<Node<T>>& sub, 
-								const std::shared_ptr<Node<T>>& org)
+bool BinaryTree<T>::isSubTree(const Node<T>* sub, 
+								const Node<T>* org)
 {
 	if (!sub)
 		return true;
@@ -900,8 +1319,8 @@ bool BinaryTree<T>::isSubTree(const std::shared_ptr<Node<T>>& sub,
 }
 
 template<typename T>
-bool BinaryTree<T>::identical(const std::shared_ptr<Node<T>>& sub, 
-								const std::shared_ptr<Node<T>>& org)
+bool BinaryTree<T>::identical(const Node<T>* sub, 
+								const Node<T>* org)
 {
 	if (!sub && !org)
 		return true;
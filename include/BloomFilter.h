@@ -0,0 +1,173 @@
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+
+#include "Hash.h"
+#include "CacheAlignedAllocator.h"
+#include "TreeKernels.h"
+
+namespace kernels
+{
+
+// A split block Bloom filter block is eight 32-bit words; a key sets
+// one bit in each. h is the low half of the key's hash. As in
+// TreeKernels.h the AVX2 versions are compiled with a target attribute
+// and picked at run time.
+
+// Odd multipliers, one per word; the top 5 bits of the product give
+// the bit to set.
+const uint32_t bloomSalt[8] = {
+	0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du,
+	0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u
+};
+
+inline uint32_t bloomBit(uint32_t h, size_t i)
+{
+	return 1u << ((h * bloomSalt[i]) >> 27);
+}
+
+inline void bloomInsertScalar(uint32_t* words, uint32_t h)
+{
+	for (size_t i = 0; i < 8; ++i)
+	{
+		words[i] |= bloomBit(h, i);
+	}
+}
+
+inline bool bloomContainsScalar(const uint32_t* words, uint32_t h)
+{
+	uint32_t missing = 0;
+
+	for (size_t i = 0; i < 8; ++i)
+	{
+		missing |= ~words[i] & bloomBit(h, i);
+	}
+
+	return missing == 0;
+}
+
+#ifdef DS_HAVE_AVX2_KERNELS
+
+__attribute__((target("avx2")))
+inline __m256i bloomMaskAvx2(uint32_t h)
+{
+	__m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bloomSalt));
+	__m256i product = _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(h)), s);
+
+	return _mm256_sllv_epi32(_mm256_set1_epi32(1), _mm256_srli_epi32(product, 27));
+}
+
+// words must be 32-byte aligned.
+__attribute__((target("avx2")))
+inline void bloomInsertAvx2(uint32_t* words, uint32_t h)
+{
+	__m256i* p = reinterpret_cast<__m256i*>(words);
+
+	_mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), bloomMaskAvx2(h)));
+}
+
+__attribute__((target("avx2")))
+inline bool bloomContainsAvx2(const uint32_t* words, uint32_t h)
+{
+	const __m256i* p = reinterpret_cast<const __m256i*>(words);
+
+	return _mm256_testc_si256(_mm256_load_si256(p), bloomMaskAvx2(h));
+}
+
+#endif
+
+inline void bloomInsert(uint32_t* words, uint32_t h)
+{
+#ifdef DS_HAVE_AVX2_KERNELS
+	if (hasAvx2())
+		return bloomInsertAvx2(words, h);
+#endif
+
+	bloomInsertScalar(words, h);
+}
+
+inline bool bloomContains(const uint32_t* words, uint32_t h)
+{
+#ifdef DS_HAVE_AVX2_KERNELS
+	if (hasAvx2())
+		return bloomContainsAvx2(words, h);
+#endif
+
+	return bloomContainsScalar(words, h);
+}
+
+}
+
+// Split block Bloom filter. A key sets one bit in each of the eight
+// 32-bit words of a single 32-byte block, so insert and contains touch
+// one cache line. On a CPU with AVX2 the eight words are handled as one
+// vector, otherwise one by one; see the kernels above.
+//
+// No false negatives. About 10 bits per key give a false positive rate
+// near 1%.
+template<typename K, typename H = BytesHash<K>>
+class BloomFilter
+{
+public:
+	explicit BloomFilter(size_t expected, size_t bitsPerKey = 10)
+		: blocks_(std::max<size_t>(1, (expected * bitsPerKey + 255) / 256))
+	{	}
+
+	template<typename It>
+	BloomFilter(It first, It last, size_t bitsPerKey = 10)
+		: BloomFilter(std::distance(first, last), bitsPerKey)
+	{
+		for (; first != last; ++first)
+		{
+			insert(*first);
+		}
+	}
+
+	// Always succeeds. Returns bool like the other filters.
+	bool insert(const K& key)
+	{
+		uint64_t h = hashCode(key);
+
+		kernels::bloomInsert(block(h).words, static_cast<uint32_t>(h));
+
+		return true;
+	}
+
+	bool contains(const K& key) const
+	{
+		uint64_t h = hashCode(key);
+
+		return kernels::bloomContains(block(h).words, static_cast<uint32_t>(h));
+	}
+
+	size_t bytes() const
+	{
+		return blocks_.size() * sizeof(Block);
+	}
+
+private:
+	struct alignas(32) Block
+	{
+		uint32_t words[8] = {};
+	};
+
+	// The high half of the hash picks the block, the low half the bits.
+	Block& block(uint64_t h)
+	{
+		return blocks_[((h >> 32) * blocks_.size()) >> 32];
+	}
+
+	const Block& block(uint64_t h) const
+	{
+		return blocks_[((h >> 32) * blocks_.size()) >> 32];
+	}
+
+	std::vector<Block, CacheAlignedAllocator<Block>> blocks_;
+	H hashCode;
+};
+
+#endif
@@ -0,0 +1,400 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include "HashTable.h"
+#include "Hash.h"
+#include "Stats.h"
+
+// Slot of an entry in a cache's entry array.
+typedef uint32_t CacheIndex;
+
+const CacheIndex cacheNil = 0xFFFFFFFF;
+
+// Doubly linked list threaded through the entries' own links, so
+// moving an entry around allocates nothing.
+struct CacheList
+{
+	CacheIndex head = cacheNil;
+	CacheIndex tail = cacheNil;
+	size_t size = 0;
+
+	template<typename Slab>
+	void pushFront(Slab& s, CacheIndex i)
+	{
+		s[i].links.prev = cacheNil;
+		s[i].links.next = head;
+
+		if (head != cacheNil)
+			s[head].links.prev = i;
+		else
+			tail = i;
+
+		head = i;
+		++size;
+	}
+
+	template<typename Slab>
+	void unlink(Slab& s, CacheIndex i)
+	{
+		CacheIndex prev = s[i].links.prev;
+		CacheIndex next = s[i].links.next;
+
+		if (prev != cacheNil)
+			s[prev].links.next = next;
+		else
+			head = next;
+
+		if (next != cacheNil)
+			s[next].links.prev = prev;
+		else
+			tail = prev;
+
+		--size;
+	}
+};
+
+// Eviction policies. Each declares the Links it needs in every entry
+// and is told about inserts, hits and erases; evict() picks a victim
+// among the entries it tracks and stops tracking it.
+
+// Least recently used.
+struct LruPolicy
+{
+	struct Links
+	{
+		CacheIndex prev;
+		CacheIndex next;
+	};
+
+	explicit LruPolicy(size_t)
+	{	}
+
+	template<typename Slab>
+	void insert(Slab& s, CacheIndex i, uint64_t)
+	{
+		list_.pushFront(s, i);
+	}
+
+	template<typename Slab>
+	void hit(Slab& s, CacheIndex i)
+	{
+		list_.unlink(s, i);
+		list_.pushFront(s, i);
+	}
+
+	template<typename Slab>
+	CacheIndex evict(Slab& s)
+	{
+		CacheIndex i = list_.tail;
+		list_.unlink(s, i);
+
+		return i;
+	}
+
+	template<typename Slab>
+	void erase(Slab& s, CacheIndex i)
+	{
+		list_.unlink(s, i);
+	}
+
+	CacheList list_;
+};
+
+// CLOCK: a hand sweeps the entry array, giving every entry hit since
+// the last sweep a second chance. A hit only sets a bit.
+struct ClockPolicy
+{
+	struct Links
+	{
+		bool referenced;
+		bool live;
+	};
+
+	explicit ClockPolicy(size_t)
+		: hand_(0)
+	{	}
+
+	template<typename Slab>
+	void insert(Slab& s, CacheIndex i, uint64_t)
+	{
+		s[i].links.referenced = false;
+		s[i].links.live = true;
+	}
+
+	template<typename Slab>
+	void hit(Slab& s, CacheIndex i)
+	{
+		s[i].links.referenced = true;
+	}
+
+	template<typename Slab>
+	CacheIndex evict(Slab& s)
+	{
+		while (true)
+		{
+			if (hand_ >= s.size())
+				hand_ = 0;
+
+			CacheIndex i = static_cast<CacheIndex>(hand_++);
+			Links& l = s[i].links;
+
+			if (!l.live)
+				continue;
+
+			if (!l.referenced)
+			{
+				l.live = false;
+				return i;
+			}
+
+			l.referenced = false;
+		}
+	}
+
+	template<typename Slab>
+	void erase(Slab& s, CacheIndex i)
+	{
+		s[i].links.live = false;
+	}
+
+	size_t hand_;
+};
+
+// S3-FIFO. New entries go to a small FIFO queue of a tenth of the
+// capacity. Those hit while there move on to the main FIFO queue, the
+// others are evicted and remembered in a ghost table. A key found in
+// the ghost table goes straight to the main queue. One-hit wonders and
+// scans thus never displace the main queue.
+//
+// The ghost table keeps one hash per slot and forgets on collision.
+struct S3FifoPolicy
+{
+	struct Links
+	{
+		CacheIndex prev;
+		CacheIndex next;
+		uint64_t hash;
+		uint8_t freq;
+		bool main;
+	};
+
+	explicit S3FifoPolicy(size_t capacity)
+		: smallCapacity_(std::max<size_t>(1, capacity / 10)), ghost_(std::max<size_t>(1, capacity), 0)
+	{	}
+
+	template<typename Slab>
+	void insert(Slab& s, CacheIndex i, uint64_t hash)
+	{
+		Links& l = s[i].links;
+		uint64_t& ghost = ghost_[hash % ghost_.size()];
+
+		l.hash = hash;
+		l.freq = 0;
+		l.main = ghost == hash;
+
+		if (l.main)
+		{
+			ghost = 0;
+			main_.pushFront(s, i);
+		}
+		else
+		{
+			small_.pushFront(s, i);
+		}
+	}
+
+	template<typename Slab>
+	void hit(Slab& s, CacheIndex i)
+	{
+		Links& l = s[i].links;
+
+		if (l.freq < 3)
+			++l.freq;
+	}
+
+	template<typename Slab>
+	CacheIndex evict(Slab& s)
+	{
+		while (true)
+		{
+			if (small_.size >= smallCapacity_ || main_.size == 0)
+			{
+				CacheIndex i = small_.tail;
+				Links& l = s[i].links;
+
+				small_.unlink(s, i);
+
+				if (l.freq == 0)
+				{
+					ghost_[l.hash % ghost_.size()] = l.hash;
+					return i;
+				}
+
+				l.freq = 0;
+				l.main = true;
+				main_.pushFront(s, i);
+			}
+			else
+			{
+				CacheIndex i = main_.tail;
+				Links& l = s[i].links;
+
+				main_.unlink(s, i);
+
+				if (l.freq == 0)
+					return i;
+
+				--l.freq;
+				main_.pushFront(s, i);
+			}
+		}
+	}
+
+	template<typename Slab>
+	void erase(Slab& s, CacheIndex i)
+	{
+		(s[i].links.main ? main_ : small_).unlink(s, i);
+	}
+
+	size_t smallCapacity_;
+	CacheList small_;
+	CacheList main_;
+	std::vector<uint64_t> ghost_;
+};
+
+// Cache of at most capacity entries. The entries live in one array
+// that is allocated up front, with the policy's links inside them, and
+// a HashTable maps each key to its slot. Once the cache is full a put
+// reuses the slot of the entry the policy evicts. A hit never
+// allocates, and an eviction only does while the index's chains are
+// still growing.
+//
+// Not thread safe; see ShardedCache.
+template <typename K, typename V, typename Policy = LruPolicy, typename F = sampleHash<K>>
+class Cache
+{
+public:
+	// capacity must be at least 1.
+	explicit Cache(size_t capacity)
+		: index_(capacity), policy_(capacity), capacity_(capacity)
+	{
+		entries_.reserve(capacity);
+	}
+
+	// Pointer to the value of key, or nullptr. It stays valid until
+	// the next put() or erase(). Counts as a hit or a miss.
+	V* get(const K& key)
+	{
+		CacheIndex* i = index_.find(key);
+
+		if (!i)
+		{
+			++stats_.misses;
+			return nullptr;
+		}
+
+		++stats_.hits;
+		policy_.hit(entries_, *i);
+
+		return &entries_[*i].value;
+	}
+
+	// Neither counted nor seen by the policy.
+	bool contains(const K& key)
+	{
+		return index_.contains(key);
+	}
+
+	// Evicts an entry if the cache is full and key is new.
+	void put(const K& key, const V& value)
+	{
+		CacheIndex* found = index_.find(key);
+
+		if (found)
+		{
+			entries_[*found].value = value;
+			policy_.hit(entries_, *found);
+			return;
+		}
+
+		CacheIndex i;
+
+		if (!free_.empty())
+		{
+			i = free_.back();
+			free_.pop_back();
+		}
+		else if (entries_.size() < capacity_)
+		{
+			i = static_cast<CacheIndex>(entries_.size());
+			entries_.push_back(Entry{ key, value, typename Policy::Links() });
+		}
+		else
+		{
+			i = policy_.evict(entries_);
+			index_.erase(entries_[i].key);
+			++stats_.evictions;
+		}
+
+		entries_[i].key = key;
+		entries_[i].value = value;
+
+		index_.put(key, i);
+		policy_.insert(entries_, i, mix64(hashCode(key)));
+		++stats_.inserts;
+	}
+
+	// Returns false if key was not cached.
+	bool erase(const K& key)
+	{
+		CacheIndex* found = index_.find(key);
+
+		if (!found)
+			return false;
+
+		CacheIndex i = *found;
+
+		policy_.erase(entries_, i);
+		index_.erase(key);
+		free_.push_back(i);
+
+		return true;
+	}
+
+	size_t size() const
+	{
+		return index_.size();
+	}
+
+	size_t capacity() const
+	{
+		return capacity_;
+	}
+
+	CacheStats stats() const
+	{
+		return stats_;
+	}
+
+private:
+	struct Entry
+	{
+		K key;
+		V value;
+		typename Policy::Links links;
+	};
+
+	std::vector<Entry> entries_;
+	std::vector<CacheIndex> free_;
+	HashTable<K, CacheIndex, F> index_;
+	Policy policy_;
+	size_t capacity_;
+	CacheStats stats_;
+	F hashCode;
+};
+
+#endif
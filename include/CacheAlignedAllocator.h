@@ -0,0 +1,43 @@
+#ifndef CACHEALIGNEDALLOCATOR_H
+#define CACHEALIGNEDALLOCATOR_H
+
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+
+// Allocates on cache-line boundaries. Over-aligned types are not
+// honoured by the default allocator before C++17.
+template<typename T>
+struct CacheAlignedAllocator
+{
+	typedef T value_type;
+
+	CacheAlignedAllocator() = default;
+
+	template<typename U>
+	CacheAlignedAllocator(const CacheAlignedAllocator<U>&)
+	{	}
+
+	T* allocate(size_t n)
+	{
+		void* p = nullptr;
+
+		if (posix_memalign(&p, 64, n * sizeof(T)) != 0)
+			throw std::bad_alloc();
+
+		return static_cast<T*>(p);
+	}
+
+	void deallocate(T* p, size_t)
+	{
+		free(p);
+	}
+
+	template<typename U>
+	bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+
+	template<typename U>
+	bool operator!=(const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+#endif
@@ -0,0 +1,232 @@
+#ifndef CUCKOOFILTER_H
+#define CUCKOOFILTER_H
+
+#include <vector>
+#include <iterator>
+#include <utility>
+#include <cstdint>
+
+#include "Hash.h"
+
+// Cuckoo filter: 16-bit fingerprints in buckets of four. A key's
+// fingerprint can be in bucket i1 or i2 = i1 ^ hash(fingerprint), so
+// either bucket can be found from the other and fingerprints can be
+// kicked out without the key. Unlike a Bloom filter, a key that was
+// inserted can be erased again.
+//
+// False positive rate about 8 / 2^16 at full load.
+template<typename K, typename H = BytesHash<K>>
+class CuckooFilter
+{
+public:
+	static const size_t Slots = 4;
+
+	// Room for capacity keys at a 95% load.
+	explicit CuckooFilter(size_t capacity)
+		: buckets_(bucketsFor(capacity)), size_(0), victim_(0), rng_(0x9E3779B97F4A7C15ull)
+	{	}
+
+	// Grows until every key fits. The keys should be distinct: more
+	// than eight copies of one key never fit.
+	template<typename It>
+	CuckooFilter(It first, It last)
+		: CuckooFilter(std::distance(first, last))
+	{
+		bool done = false;
+
+		while (!done)
+		{
+			done = true;
+
+			for (It it = first; it != last; ++it)
+			{
+				if (!insert(*it))
+				{
+					*this = CuckooFilter(buckets_.size() * Slots * 2);
+					done = false;
+					break;
+				}
+			}
+		}
+	}
+
+	// Returns false if the filter is full. The filter then still
+	// answers correctly for the keys inserted so far, including this
+	// one, but takes no more keys until one is erased.
+	bool insert(const K& key)
+	{
+		if (victim_)
+			return false;
+
+		uint64_t h = hashCode(key);
+		uint16_t fp = fingerprint(h);
+		size_t i = index(h);
+
+		if (add(i, fp) || add(alternate(i, fp), fp))
+		{
+			++size_;
+			return true;
+		}
+
+		// Kick a random fingerprint to its other bucket, and so on.
+		for (size_t kick = 0; kick < MaxKicks; ++kick)
+		{
+			rng_ ^= rng_ << 13;
+			rng_ ^= rng_ >> 7;
+			rng_ ^= rng_ << 17;
+
+			std::swap(fp, buckets_[i].fp[rng_ % Slots]);
+			i = alternate(i, fp);
+
+			if (add(i, fp))
+			{
+				++size_;
+				return true;
+			}
+		}
+
+		victim_ = fp;
+		victimIndex_ = i;
+		++size_;
+
+		return false;
+	}
+
+	bool contains(const K& key) const
+	{
+		uint64_t h = hashCode(key);
+		uint16_t fp = fingerprint(h);
+		size_t i1 = index(h);
+		size_t i2 = alternate(i1, fp);
+
+		return has(i1, fp) || has(i2, fp) ||
+				(victim_ == fp && (victimIndex_ == i1 || victimIndex_ == i2));
+	}
+
+	// Only for keys that were inserted: erasing any other key may
+	// remove a fingerprint it shares with an inserted one.
+	bool erase(const K& key)
+	{
+		uint64_t h = hashCode(key);
+		uint16_t fp = fingerprint(h);
+		size_t i1 = index(h);
+		size_t i2 = alternate(i1, fp);
+
+		if (victim_ == fp && (victimIndex_ == i1 || victimIndex_ == i2))
+		{
+			victim_ = 0;
+			--size_;
+			return true;
+		}
+
+		if (!remove(i1, fp) && !remove(i2, fp))
+			return false;
+
+		--size_;
+
+		// The evicted fingerprint fits again now.
+		if (victim_ && (add(victimIndex_, victim_) || add(alternate(victimIndex_, victim_), victim_)))
+			victim_ = 0;
+
+		return true;
+	}
+
+	size_t size() const
+	{
+		return size_;
+	}
+
+	size_t bytes() const
+	{
+		return buckets_.size() * sizeof(Bucket);
+	}
+
+private:
+	static const size_t MaxKicks = 500;
+
+	struct Bucket
+	{
+		// 0 marks a free slot.
+		uint16_t fp[Slots] = {};
+	};
+
+	static size_t bucketsFor(size_t capacity)
+	{
+		size_t n = 1;
+
+		while (n * Slots * 95 < capacity * 100)
+			n *= 2;
+
+		return n;
+	}
+
+	static uint16_t fingerprint(uint64_t h)
+	{
+		uint16_t fp = static_cast<uint16_t>(h >> 48);
+
+		return fp ? fp : 1;
+	}
+
+	size_t index(uint64_t h) const
+	{
+		return h & (buckets_.size() - 1);
+	}
+
+	size_t alternate(size_t i, uint16_t fp) const
+	{
+		return (i ^ mix64(fp)) & (buckets_.size() - 1);
+	}
+
+	bool has(size_t i, uint16_t fp) const
+	{
+		const Bucket& b = buckets_[i];
+
+		return b.fp[0] == fp || b.fp[1] == fp || b.fp[2] == fp || b.fp[3] == fp;
+	}
+
+	bool add(size_t i, uint16_t fp)
+	{
+		for (auto& slot : buckets_[i].fp)
+		{
+			if (!slot)
+			{
+				slot = fp;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool remove(size_t i, uint16_t fp)
+	{
+		for (auto& slot : buckets_[i].fp)
+		{
+			if (slot == fp)
+			{
+				slot = 0;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	std::vector<Bucket> buckets_;
+	size_t size_;
+
+	// The fingerprint left over when insert gave up, and its bucket.
+	uint16_t victim_;
+	size_t victimIndex_ = 0;
+
+	uint64_t rng_;
+	H hashCode;
+};
+
+template<typename K, typename H>
+const size_t CuckooFilter<K, H>::Slots;
+
+template<typename K, typename H>
+const size_t CuckooFilter<K, H>::MaxKicks;
+
+#endif
@@ -0,0 +1,384 @@
+#ifndef CUCKOOHASHTABLE_H
+#define CUCKOOHASHTABLE_H
+
+#include <vector>
+#include <cstdint>
+
+#include "HashTable.h"	// sampleHash
+#include "Hash.h"
+#include "Stats.h"
+#include "CacheAlignedAllocator.h"
+
+// Bucketized cuckoo hashing. Every key has two candidate buckets of
+// four slots each and lives in one of them, so a lookup reads at most
+// two buckets - two cache lines for small keys and values - however
+// the keys collide.
+//
+// An insert that finds both buckets full searches breadth first for a
+// short chain of keys to move to their other bucket, then moves them
+// from the free end backwards. No key is ever without a slot, and the
+// work per insert is bounded by MaxSearch. If no chain is found the
+// table doubles.
+template <typename K, typename V, typename F = sampleHash<K>>
+class CuckooHashTable
+{
+public:
+	static const size_t Slots = 4;
+
+	// Room for at least size entries before the first resize.
+	explicit CuckooHashTable(size_t size = 16)
+		: table_(bucketsFor(size)), size_(0)
+	{	}
+
+	// Value of key, or V{} if it is not present.
+	V get(const K& key) const
+	{
+		const V* v = find(key);
+
+		return v ? *v : V{};
+	}
+
+	bool contains(const K& key) const
+	{
+		return find(key) != nullptr;
+	}
+
+	// Pointer to the value of key, or nullptr.
+	const V* find(const K& key) const
+	{
+		size_t h = hash(key);
+		size_t b1 = first(h);
+
+		int slot = table_[b1].find(key);
+
+		if (slot >= 0)
+		{
+			DS_STATS_ONLY(recordProbe(1);)
+			return &table_[b1].values[slot];
+		}
+
+		size_t b2 = second(h, b1);
+
+		slot = table_[b2].find(key);
+
+		DS_STATS_ONLY(recordProbe(2);)
+
+		return slot >= 0 ? &table_[b2].values[slot] : nullptr;
+	}
+
+	void put(const K& key, const V& value)
+	{
+		size_t h = hash(key);
+		size_t b1 = first(h);
+		size_t b2 = second(h, b1);
+
+		int slot = table_[b1].find(key);
+
+		if (slot >= 0)
+		{
+			table_[b1].values[slot] = value;
+			return;
+		}
+
+		slot = table_[b2].find(key);
+
+		if (slot >= 0)
+		{
+			table_[b2].values[slot] = value;
+			return;
+		}
+
+		insert(key, value, h);
+	}
+
+	// Returns false if key was not present.
+	bool erase(const K& key)
+	{
+		size_t h = hash(key);
+		size_t b1 = first(h);
+		size_t b2 = second(h, b1);
+
+		for (size_t b : { b1, b2 })
+		{
+			int slot = table_[b].find(key);
+
+			if (slot >= 0)
+			{
+				table_[b].occupied &= ~(1u << slot);
+				--size_;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Number of entries.
+	size_t size() const
+	{
+		return size_;
+	}
+
+	size_t bucketCount() const
+	{
+		return table_.size();
+	}
+
+	// Entries over slots.
+	double loadFactor() const
+	{
+		return static_cast<double>(size_) / (table_.size() * Slots);
+	}
+
+	// Calls f(key, value) for every entry, bucket by bucket.
+	template<typename Fn>
+	void forEach(Fn f) const
+	{
+		for (const auto& bucket : table_)
+		{
+			for (size_t s = 0; s < Slots; ++s)
+			{
+				if (bucket.occupied & (1u << s))
+					f(bucket.keys[s], bucket.values[s]);
+			}
+		}
+	}
+
+	// Same fields as HashTable::stats(). The load factor is over slots,
+	// chainLengths is the bucket occupancy and a probe is one bucket.
+	HashTableStats stats() const
+	{
+		HashTableStats s;
+
+#ifdef DS_STATS
+		s = counters_;
+#endif
+
+		s.buckets = table_.size();
+		s.entries = size_;
+		s.loadFactor = loadFactor();
+		s.bytesAllocated = table_.capacity() * sizeof(Bucket);
+
+		for (const auto& bucket : table_)
+		{
+			recordHistogram(s.chainLengths, __builtin_popcount(bucket.occupied));
+		}
+
+		return s;
+	}
+
+private:
+	// Nodes visited by the breadth first search of one insert.
+	static const size_t MaxSearch = 512;
+
+	// Four keys and values side by side, so that for int/int a bucket
+	// is exactly one cache line.
+	struct alignas(64) Bucket
+	{
+		K keys[Slots];
+		V values[Slots];
+		uint8_t occupied = 0;
+
+		int find(const K& key) const
+		{
+			for (size_t s = 0; s < Slots; ++s)
+			{
+				if ((occupied & (1u << s)) && keys[s] == key)
+					return static_cast<int>(s);
+			}
+
+			return -1;
+		}
+
+		int freeSlot() const
+		{
+			return occupied == (1u << Slots) - 1 ? -1 : __builtin_ctz(~occupied);
+		}
+	};
+
+	// A bucket reached in the search by moving the key in
+	// parent's slot into it.
+	struct Step
+	{
+		size_t bucket;
+		int parent;
+		int slot;
+	};
+
+	static size_t bucketsFor(size_t size)
+	{
+		// A power of two, so the bucket is a mask of the hash.
+		size_t n = 2;
+
+		while (n * Slots < size)
+			n *= 2;
+
+		return n;
+	}
+
+	// The user's hash may be the identity, so mix it before taking
+	// bits from it.
+	size_t hash(const K& key) const
+	{
+		return mix64(hashCode(key));
+	}
+
+	size_t first(size_t h) const
+	{
+		return h & (table_.size() - 1);
+	}
+
+	// Never the same bucket as the first one.
+	size_t second(size_t h, size_t b1) const
+	{
+		size_t b2 = (h >> 32) & (table_.size() - 1);
+
+		return b2 != b1 ? b2 : b1 ^ 1;
+	}
+
+	// The candidate bucket of key that is not b.
+	size_t other(const K& key, size_t b) const
+	{
+		size_t h = hash(key);
+		size_t b1 = first(h);
+
+		return b1 != b ? b1 : second(h, b1);
+	}
+
+	// key is known not to be present.
+	void insert(const K& key, const V& value, size_t h)
+	{
+		while (true)
+		{
+			size_t b1 = first(h);
+			size_t b2 = second(h, b1);
+
+			for (size_t b : { b1, b2 })
+			{
+				int slot = table_[b].freeSlot();
+
+				if (slot >= 0)
+				{
+					place(b, slot, key, value);
+					return;
+				}
+			}
+
+			if (makeRoom(b1, b2, key, value))
+				return;
+
+			grow();
+			h = hash(key);
+		}
+	}
+
+	bool makeRoom(size_t b1, size_t b2, const K& key, const V& value)
+	{
+		std::vector<Step> steps;
+		steps.reserve(MaxSearch);
+		steps.push_back(Step{ b1, -1, -1 });
+		steps.push_back(Step{ b2, -1, -1 });
+
+		for (size_t i = 0; i < steps.size(); ++i)
+		{
+			const Bucket& bucket = table_[steps[i].bucket];
+			int free = bucket.freeSlot();
+
+			if (free >= 0)
+				return shift(steps, i, free, key, value);
+
+			for (size_t s = 0; s < Slots && steps.size() < MaxSearch; ++s)
+			{
+				steps.push_back(Step{ other(bucket.keys[s], steps[i].bucket),
+						static_cast<int>(i), static_cast<int>(s) });
+			}
+		}
+
+		return false;
+	}
+
+	// Moves the keys along the path ending at steps[i], last one first,
+	// then puts key in the slot freed at the start of the path. The
+	// path may visit a bucket twice, so each move is checked again
+	// before it is made; a stale path is abandoned, leaving every key
+	// in one of its buckets.
+	bool shift(const std::vector<Step>& steps, size_t i, int free,
+			const K& key, const V& value)
+	{
+		while (steps[i].parent >= 0)
+		{
+			const Step& to = steps[i];
+			Bucket& from = table_[steps[to.parent].bucket];
+			int slot = to.slot;
+
+			if (!(from.occupied & (1u << slot)) || (table_[to.bucket].occupied & (1u << free)) ||
+					other(from.keys[slot], steps[to.parent].bucket) != to.bucket)
+				return false;
+
+			place(to.bucket, free, from.keys[slot], from.values[slot]);
+			from.occupied &= ~(1u << slot);
+			--size_;
+
+			free = slot;
+			i = to.parent;
+		}
+
+		if (table_[steps[i].bucket].occupied & (1u << free))
+			return false;
+
+		place(steps[i].bucket, free, key, value);
+
+		return true;
+	}
+
+	void place(size_t b, int slot, const K& key, const V& value)
+	{
+		table_[b].keys[slot] = key;
+		table_[b].values[slot] = value;
+		table_[b].occupied |= 1u << slot;
+		++size_;
+	}
+
+	void grow()
+	{
+		Table old(table_.size() * 2);
+		old.swap(table_);
+		size_ = 0;
+
+		for (const auto& bucket : old)
+		{
+			for (size_t s = 0; s < Slots; ++s)
+			{
+				if (bucket.occupied & (1u << s))
+					insert(bucket.keys[s], bucket.values[s], hash(bucket.keys[s]));
+			}
+		}
+
+		DS_STATS_ONLY(++counters_.resizes;)
+	}
+
+#ifdef DS_STATS
+	void recordProbe(size_t probes) const
+	{
+		++counters_.lookups;
+		counters_.probes += probes;
+		counters_.maxProbe = std::max(counters_.maxProbe, probes);
+	}
+
+	mutable HashTableStats counters_;
+#endif
+
+	typedef std::vector<Bucket, CacheAlignedAllocator<Bucket>> Table;
+
+	Table table_;
+	size_t size_;
+	mutable F hashCode;
+};
+
+template <typename K, typename V, typename F>
+const size_t CuckooHashTable<K, V, F>::Slots;
+
+template <typename K, typename V, typename F>
+const size_t CuckooHashTable<K, V, F>::MaxSearch;
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef DARYHEAP_H
+#define DARYHEAP_H
+
+#include <vector>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+// Implicit d-ary heap in a vector: the children of i are d i + 1 to
+// d i + d. top() is the element that comes first under Compare, i.e.
+// the smallest with std::less (std::priority_queue gives the largest).
+//
+// A wider node makes the heap log2(d) times shallower and keeps the d
+// children next to each other, so a pop reads fewer cache lines than
+// a binary heap at the cost of more compares per level. d = 4 or 8
+// suits small keys.
+//
+// Elements are moved into a hole instead of swapped, one move per level.
+template<typename T, size_t D = 4, typename Compare = std::less<T>>
+class DaryHeap
+{
+	static_assert(D >= 2, "DaryHeap needs at least two children per node");
+
+public:
+	explicit DaryHeap(Compare compare = Compare())
+		: compare_(compare)
+	{	}
+
+	// Bulk build in O(n).
+	template<typename InputIt>
+	DaryHeap(InputIt first, InputIt last, Compare compare = Compare())
+		: data_(first, last), compare_(compare)
+	{
+		heapify();
+	}
+
+	void push(const T& value)
+	{
+		data_.push_back(value);
+		siftUp(data_.size() - 1);
+	}
+
+	const T& top() const
+	{
+		return data_.front();
+	}
+
+	// The hole left at the root goes down to a leaf along the first
+	// children, and the last element then moves up from there, as it
+	// mostly belongs near the bottom: about half the compares of a
+	// plain sift down.
+	void pop()
+	{
+		T last = std::move(data_.back());
+
+		data_.pop_back();
+
+		if (data_.empty())
+			return;
+
+		size_t hole = 0;
+		size_t n = data_.size();
+
+		while (D * hole + 1 < n)
+		{
+			size_t best = firstChild(hole);
+
+			data_[hole] = std::move(data_[best]);
+			hole = best;
+		}
+
+		data_[hole] = std::move(last);
+		siftUp(hole);
+	}
+
+	size_t size() const
+	{
+		return data_.size();
+	}
+
+	bool empty() const
+	{
+		return data_.empty();
+	}
+
+	void reserve(size_t n)
+	{
+		data_.reserve(n);
+	}
+
+	void clear()
+	{
+		data_.clear();
+	}
+
+	// Adds the values and restores the heap bottom up, O(n + k).
+	template<typename InputIt>
+	void pushAll(InputIt first, InputIt last)
+	{
+		data_.insert(data_.end(), first, last);
+		heapify();
+	}
+
+private:
+	// Floyd: sift down every inner node, last first.
+	void heapify()
+	{
+		if (data_.size() < 2)
+			return;
+
+		for (size_t i = (data_.size() - 2) / D + 1; i-- > 0; )
+		{
+			T value = std::move(data_[i]);
+			siftDown(i, std::move(value));
+		}
+	}
+
+	void siftUp(size_t hole)
+	{
+		T value = std::move(data_[hole]);
+
+		while (hole > 0)
+		{
+			size_t parent = (hole - 1) / D;
+
+			if (!compare_(value, data_[parent]))
+				break;
+
+			data_[hole] = std::move(data_[parent]);
+			hole = parent;
+		}
+
+		data_[hole] = std::move(value);
+	}
+
+	// The child of i, which must have one, that comes first.
+	size_t firstChild(size_t i)
+	{
+		size_t first = D * i + 1;
+		size_t last = first + D < data_.size() ? first + D : data_.size();
+		size_t best = first;
+
+		for (size_t c = first + 1; c < last; ++c)
+		{
+			if (compare_(data_[c], data_[best]))
+				best = c;
+		}
+
+		return best;
+	}
+
+	// Puts value at hole or below, moving the first child up while it
+	// comes before value.
+	void siftDown(size_t hole, T value)
+	{
+		size_t n = data_.size();
+
+		while (D * hole + 1 < n)
+		{
+			size_t best = firstChild(hole);
+
+			if (!compare_(data_[best], value))
+				break;
+
+			data_[hole] = std::move(data_[best]);
+			hole = best;
+		}
+
+		data_[hole] = std::move(value);
+	}
+
+	std::vector<T> data_;
+	Compare compare_;
+};
+
+#endif
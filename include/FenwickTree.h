@@ -0,0 +1,75 @@
+#ifndef FENWICKTREE_H
+#define FENWICKTREE_H
+
+#include <vector>
+#include <iterator>
+
+// Fenwick (binary indexed) tree: prefix sums with point updates, both
+// O(log n), in one array of n values. Entry i (1-based) holds the sum
+// of the lowbit(i) values ending at i.
+//
+// Range sums subtract two prefixes, hence T needs + and -. For min or
+// max, or for range adds, use SegmentTree.
+template<typename T>
+class FenwickTree
+{
+public:
+	// n values, all T{}.
+	explicit FenwickTree(size_t n = 0)
+		: tree_(n + 1, T{})
+	{	}
+
+	// Built in O(n): each entry passes its sum on to its parent.
+	template<typename InputIt>
+	FenwickTree(InputIt first, InputIt last)
+		: tree_(1, T{})
+	{
+		tree_.insert(tree_.end(), first, last);
+
+		for (size_t i = 1; i < tree_.size(); ++i)
+		{
+			size_t parent = i + (i & (0 - i));
+
+			if (parent < tree_.size())
+				tree_[parent] += tree_[i];
+		}
+	}
+
+	size_t size() const
+	{
+		return tree_.size() - 1;
+	}
+
+	// Adds delta to value i.
+	void add(size_t i, const T& delta)
+	{
+		for (++i; i < tree_.size(); i += i & (0 - i))
+		{
+			tree_[i] += delta;
+		}
+	}
+
+	// Sum of the first n values.
+	T prefix(size_t n) const
+	{
+		T sum = T{};
+
+		for (; n > 0; n -= n & (0 - n))
+		{
+			sum += tree_[n];
+		}
+
+		return sum;
+	}
+
+	// Sum of [first, last).
+	T sum(size_t first, size_t last) const
+	{
+		return first < last ? prefix(last) - prefix(first) : T{};
+	}
+
+private:
+	std::vector<T> tree_;
+};
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef FIXEDHASHTABLE_H
+#define FIXEDHASHTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Fibonacci hashing: multiply by 2^64 / golden ratio and keep the top
+// bits. Spreads sequential keys well and needs no division.
+template<typename K>
+struct FibonacciHash
+{
+	static_assert(std::is_integral<K>::value || std::is_enum<K>::value,
+			"FibonacciHash needs an integral key. Pass a constexpr hash.");
+
+	constexpr uint64_t operator()(const K& key) const
+	{
+		return static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+	}
+};
+
+// Slot i of the probe sequence, relative to the home slot.
+struct LinearProbe
+{
+	static constexpr size_t offset(size_t i) { return i; }
+};
+
+// Triangular numbers. For a power of two capacity they still visit
+// every slot, but break up the clusters linear probing builds.
+struct QuadraticProbe
+{
+	static constexpr size_t offset(size_t i) { return i * (i + 1) / 2; }
+};
+
+// Linear probing while all the keys fit in a few cache lines, where
+// scanning neighbours is cheapest; quadratic probing beyond that.
+template<typename K, size_t Capacity>
+struct DefaultProbe
+{
+	typedef typename std::conditional<(Capacity * sizeof(K) <= 256),
+			LinearProbe, QuadraticProbe>::type type;
+};
+
+// Open addressing hash table with a capacity fixed at compile time.
+// All the storage is inline, so it never touches the heap and can be
+// built and queried in constant expressions.
+//
+// Capacity must be a power of two: the slot is taken from the top
+// bits of the hash instead of a modulo.
+template <typename K, typename V, size_t Capacity,
+		typename F = FibonacciHash<K>,
+		typename P = typename DefaultProbe<K, Capacity>::type>
+class FixedHashTable
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+			"Capacity must be a power of two");
+
+public:
+	constexpr FixedHashTable()
+		: keys_{}, values_{}, used_{}, size_(0)
+	{	}
+
+	// Returns false if the table is full.
+	constexpr bool put(const K& key, const V& value)
+	{
+		size_t slot = find(key);
+
+		if (slot == Capacity)
+			return false;
+
+		if (!used_[slot])
+		{
+			used_[slot] = true;
+			keys_[slot] = key;
+			++size_;
+		}
+
+		values_[slot] = value;
+
+		return true;
+	}
+
+	// Value of key, or V{} if it is not present.
+	constexpr V get(const K& key) const
+	{
+		size_t slot = find(key);
+
+		return (slot != Capacity && used_[slot]) ? values_[slot] : V{};
+	}
+
+	constexpr bool contains(const K& key) const
+	{
+		size_t slot = find(key);
+
+		return slot != Capacity && used_[slot];
+	}
+
+	constexpr size_t size() const
+	{
+		return size_;
+	}
+
+	static constexpr size_t capacity()
+	{
+		return Capacity;
+	}
+
+	constexpr void clear()
+	{
+		for (size_t i = 0; i < Capacity; ++i)
+		{
+			used_[i] = false;
+		}
+
+		size_ = 0;
+	}
+
+private:
+	static constexpr size_t log2(size_t n)
+	{
+		return n <= 1 ? 0 : 1 + log2(n / 2);
+	}
+
+	static constexpr size_t home(const K& key)
+	{
+		// Top log2(Capacity) bits. A shift by 64 is undefined,
+		// hence the special case for Capacity 1.
+		return Capacity == 1 ? 0 :
+				static_cast<size_t>(F()(key) >> (64 - log2(Capacity)));
+	}
+
+	// Slot holding key, else the first free slot of its probe
+	// sequence, else Capacity.
+	constexpr size_t find(const K& key) const
+	{
+		size_t h = home(key);
+
+		for (size_t i = 0; i < Capacity; ++i)
+		{
+			size_t slot = (h + P::offset(i)) & (Capacity - 1);
+
+			if (!used_[slot] || keys_[slot] == key)
+				return slot;
+		}
+
+		return Capacity;
+	}
+
+	K keys_[Capacity];
+	V values_[Capacity];
+	bool used_[Capacity];
+	size_t size_;
+};
+
+#endif
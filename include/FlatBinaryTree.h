@@ -0,0 +1,414 @@
+#ifndef FLATBINARYTREE_H
+#define FLATBINARYTREE_H
+
+#include <initializer_list>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include "BinaryTree.h"
+#include "TreeKernels.h"
+
+// Structure-of-arrays binary tree. Keys live in one contiguous array
+// and the children are 32-bit indices in two parallel arrays, so a
+// Node<int> costs 12 bytes instead of a heap node with two pointers.
+//
+// Nodes are stored in level order. A traversal therefore walks the
+// arrays mostly forward, which suits the hardware prefetcher, and
+// the predicates that look at every node run as flat loops over the
+// arrays (see TreeKernels.h).
+template<typename T>
+class FlatBinaryTree
+{
+public:
+	typedef uint32_t Index;
+
+	// Marks a missing child.
+	static const Index nil = 0xFFFFFFFF;
+
+	explicit FlatBinaryTree()
+		: mirrored_(false)
+	{	}
+
+	// Same shape as BinaryTree(il): fill the tree level by level.
+	explicit FlatBinaryTree(std::initializer_list<T> il);
+
+	explicit FlatBinaryTree(const BinaryTree<T>& t);
+
+	FlatBinaryTree(const FlatBinaryTree& t) = default;
+	FlatBinaryTree& operator=(const FlatBinaryTree& t) = default;
+
+	FlatBinaryTree(FlatBinaryTree&& t) = default;
+	FlatBinaryTree& operator=(FlatBinaryTree&& t) = default;
+
+	~FlatBinaryTree() = default;
+
+	std::vector<T> inorder() const;
+	std::vector<T> postorder() const;
+	std::vector<T> preorder() const;
+	std::vector<T> levelorder() const;
+
+	size_t size() const;
+	size_t height() const;
+	size_t leafCount() const;
+
+	bool isBST() const;
+	bool isSumProperty() const;
+
+	void mirror();
+
+	// Lowest Common Ancestor. Returns nil if neither value is present.
+	Index lca(const T& data1, const T& data2) const;
+
+	Index root() const { return keys_.empty() ? nil : 0; }
+	Index left(Index i) const { return left_[i]; }
+	Index right(Index i) const { return right_[i]; }
+	const T& data(Index i) const { return keys_[i]; }
+
+	// Bytes held by the three arrays.
+	size_t memoryUsage() const;
+
+private:
+	Index find(const T& data) const;
+
+	std::vector<T> keys_;
+	std::vector<Index> left_;
+	std::vector<Index> right_;
+
+	// After mirror() the storage order is no longer level order.
+	bool mirrored_;
+};
+
+template<typename T>
+const typename FlatBinaryTree<T>::Index FlatBinaryTree<T>::nil;
+
+template<typename T>
+FlatBinaryTree<T>::FlatBinaryTree(std::initializer_list<T> il)
+	: keys_(il), mirrored_(false)
+{
+	// Level-order insertion builds a complete tree, i.e. the
+	// children of node i are 2i + 1 and 2i + 2.
+	size_t n = keys_.size();
+
+	left_.resize(n, nil);
+	right_.resize(n, nil);
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (2 * i + 1 < n)
+			left_[i] = static_cast<Index>(2 * i + 1);
+
+		if (2 * i + 2 < n)
+			right_[i] = static_cast<Index>(2 * i + 2);
+	}
+}
+
+template<typename T>
+FlatBinaryTree<T>::FlatBinaryTree(const BinaryTree<T>& t)
+	: mirrored_(false)
+{
+	if (!t.root_)
+		return;
+
+	// Breadth first, so the nodes end up in level order. The queue is
+	// the list of nodes itself: node i is nodes[i].
+	std::vector<const Node<T>*> nodes;
+	nodes.push_back(t.root_);
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		const Node<T>* temp = nodes[i];
+
+		keys_.push_back(temp->data);
+		left_.push_back(nil);
+		right_.push_back(nil);
+
+		if (temp->left)
+		{
+			left_[i] = static_cast<Index>(nodes.size());
+			nodes.push_back(temp->left);
+		}
+
+		if (temp->right)
+		{
+			right_[i] = static_cast<Index>(nodes.size());
+			nodes.push_back(temp->right);
+		}
+	}
+}
+
+template<typename T>
+std::vector<T> FlatBinaryTree<T>::inorder() const
+{
+	// The output size is known, so write straight into it.
+	std::vector<T> v(keys_.size());
+	T* out = v.data();
+	std::vector<Index> s;
+	Index current = root();
+
+	while (current != nil || !s.empty())
+	{
+		if (current != nil)
+		{
+			s.push_back(current);
+			current = left_[current];
+		}
+		else
+		{
+			current = s.back();
+			s.pop_back();
+
+			*out++ = keys_[current];
+			current = right_[current];
+		}
+	}
+
+	return v;
+}
+
+template<typename T>
+std::vector<T> FlatBinaryTree<T>::postorder() const
+{
+	// Reverse of the root-right-left preorder, written from the back.
+	std::vector<T> v(keys_.size());
+	T* out = v.data() + v.size();
+	std::vector<Index> s;
+
+	if (root() != nil)
+		s.push_back(root());
+
+	while (!s.empty())
+	{
+		Index i = s.back();
+		s.pop_back();
+
+		*--out = keys_[i];
+
+		if (left_[i] != nil)
+			s.push_back(left_[i]);
+
+		if (right_[i] != nil)
+			s.push_back(right_[i]);
+	}
+
+	return v;
+}
+
+template<typename T>
+std::vector<T> FlatBinaryTree<T>::preorder() const
+{
+	std::vector<T> v(keys_.size());
+	T* out = v.data();
+	std::vector<Index> s;
+
+	if (root() != nil)
+		s.push_back(root());
+
+	while (!s.empty())
+	{
+		Index i = s.back();
+		s.pop_back();
+
+		*out++ = keys_[i];
+
+		if (right_[i] != nil)
+			s.push_back(right_[i]);
+
+		if (left_[i] != nil)
+			s.push_back(left_[i]);
+	}
+
+	return v;
+}
+
+template<typename T>
+std::vector<T> FlatBinaryTree<T>::levelorder() const
+{
+	// The storage order: a single copy.
+	if (!mirrored_)
+		return keys_;
+
+	std::vector<T> v;
+	std::vector<Index> q;
+
+	v.reserve(keys_.size());
+	q.reserve(keys_.size());
+
+	if (root() != nil)
+		q.push_back(root());
+
+	for (size_t head = 0; head < q.size(); ++head)
+	{
+		Index i = q[head];
+
+		v.push_back(keys_[i]);
+
+		if (left_[i] != nil)
+			q.push_back(left_[i]);
+
+		if (right_[i] != nil)
+			q.push_back(right_[i]);
+	}
+
+	return v;
+}
+
+template<typename T>
+size_t FlatBinaryTree<T>::size() const
+{
+	return keys_.size();
+}
+
+template<typename T>
+size_t FlatBinaryTree<T>::height() const
+{
+	// Level by level. q[begin, end) holds the current level.
+	std::vector<Index> q;
+	size_t h = 0;
+
+	q.reserve(keys_.size());
+
+	if (root() != nil)
+		q.push_back(root());
+
+	size_t begin = 0;
+
+	while (begin < q.size())
+	{
+		size_t end = q.size();
+
+		for (size_t k = begin; k < end; ++k)
+		{
+			if (left_[q[k]] != nil)
+				q.push_back(left_[q[k]]);
+
+			if (right_[q[k]] != nil)
+				q.push_back(right_[q[k]]);
+		}
+
+		begin = end;
+		++h;
+	}
+
+	return h;
+}
+
+template<typename T>
+size_t FlatBinaryTree<T>::leafCount() const
+{
+	// Every stored node is part of the tree, so no walk is needed.
+	return kernels::leafCount(left_.data(), right_.data(), keys_.size());
+}
+
+template<typename T>
+bool FlatBinaryTree<T>::isBST() const
+{
+	// A BST with distinct keys is one whose inorder is strictly increasing.
+	std::vector<T> v = inorder();
+
+	return kernels::isStrictlyIncreasing(v.data(), v.size());
+}
+
+template<typename T>
+bool FlatBinaryTree<T>::isSumProperty() const
+{
+	return kernels::isSumProperty(keys_.data(), left_.data(), right_.data(), keys_.size());
+}
+
+template<typename T>
+void FlatBinaryTree<T>::mirror()
+{
+	// Swapping every left and right child is swapping the two arrays.
+	left_.swap(right_);
+	mirrored_ = !mirrored_;
+}
+
+template<typename T>
+typename FlatBinaryTree<T>::Index FlatBinaryTree<T>::lca(const T& data1, const T& data2) const
+{
+	Index a = find(data1);
+	Index b = find(data2);
+
+	if (a == nil)
+		return b;
+
+	if (b == nil)
+		return a;
+
+	// Parent links and depths, then climb from the deeper node.
+	std::vector<Index> parent(keys_.size(), nil);
+	std::vector<Index> depth(keys_.size(), 0);
+	std::vector<Index> s;
+
+	s.push_back(root());
+
+	while (!s.empty())
+	{
+		Index i = s.back();
+		s.pop_back();
+
+		Index children[2] = { left_[i], right_[i] };
+
+		for (Index c : children)
+		{
+			if (c != nil)
+			{
+				parent[c] = i;
+				depth[c] = depth[i] + 1;
+				s.push_back(c);
+			}
+		}
+	}
+
+	while (depth[a] > depth[b])
+		a = parent[a];
+
+	while (depth[b] > depth[a])
+		b = parent[b];
+
+	while (a != b)
+	{
+		a = parent[a];
+		b = parent[b];
+	}
+
+	return a;
+}
+
+template<typename T>
+size_t FlatBinaryTree<T>::memoryUsage() const
+{
+	return keys_.capacity() * sizeof(T) +
+			(left_.capacity() + right_.capacity()) * sizeof(Index);
+}
+
+/////////// Private Member Functions ///////////
+
+template<typename T>
+typename FlatBinaryTree<T>::Index FlatBinaryTree<T>::find(const T& data) const
+{
+	// First match in preorder, like the recursive BinaryTree::lca().
+	std::vector<Index> s;
+
+	if (root() != nil)
+		s.push_back(root());
+
+	while (!s.empty())
+	{
+		Index i = s.back();
+		s.pop_back();
+
+		if (keys_[i] == data)
+			return i;
+
+		if (right_[i] != nil)
+			s.push_back(right_[i]);
+
+		if (left_[i] != nil)
+			s.push_back(left_[i]);
+	}
+
+	return nil;
+}
+
+#endif
@@ -0,0 +1,539 @@
+#ifndef FROZENHASHMAP_H
+#define FROZENHASHMAP_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Hash.h"
+#include "HashTable.h"
+
+// Immutable map over a static key set, built on a minimal perfect hash
+// function in the style of PTHash:
+//   - keys are split into buckets (skewed: 60% of the keys go to 30% of
+//     the buckets) and each bucket gets a 16-bit pilot, found at build
+//     time, that sends all its keys to free slots;
+//   - slot = (hash ^ mix64(pilot)) mod m, with m slightly above n. The
+//     few slots >= n are remapped to the holes below n, so the n entries
+//     fill exactly n slots.
+// With ~6 keys per bucket the pilots cost ~2.7 bits per key, plus ~0.3
+// for the remap table.
+//
+// A lookup reads a pilot, then, for the ~1% of keys placed past n, a
+// remap entry, then the fingerprint if there are fingerprints, then
+// the slot. These are separate arrays, so a hit touches 2 cache lines
+// without fingerprints and 3 (rarely 4) with them, not 1. The pilots
+// take n / 3 bytes and only stay in cache for small maps. With
+// fingerprints, an extra byte per key, a miss stops at the fingerprint
+// 255 times out of 256 without reading the slot or comparing keys.
+//
+// Fewer than 2^32 keys: remap entries are 32-bit.
+//
+// Everything lives in one flat blob (data(), bytes()) that can be
+// written to a file and used again through view(), e.g. on an mmap.
+// Keys and values must be trivially copyable, and keys must not contain
+// padding: they are hashed by their bytes.
+template<typename K, typename V>
+class FrozenHashMap
+{
+	static_assert(std::is_trivially_copyable<K>::value &&
+			std::is_trivially_copyable<V>::value,
+			"FrozenHashMap needs trivially copyable keys and values");
+
+	struct Slot
+	{
+		K key;
+		V value;
+	};
+
+	static_assert(alignof(Slot) <= 8, "FrozenHashMap aligns sections to 8 bytes");
+
+public:
+	FrozenHashMap()
+		: data_(nullptr), bytes_(0), header_(nullptr)
+	{	}
+
+	FrozenHashMap(const FrozenHashMap&) = delete;
+	FrozenHashMap& operator=(const FrozenHashMap&) = delete;
+
+	// The blob of a vector stays where it is when the vector is moved,
+	// so data_ and header_ carry over; the moved-from map is empty.
+	FrozenHashMap(FrozenHashMap&& map)
+		: storage_(std::move(map.storage_)), data_(map.data_), bytes_(map.bytes_), header_(map.header_)
+	{
+		map.reset();
+	}
+
+	FrozenHashMap& operator=(FrozenHashMap&& map)
+	{
+		if (this != &map)
+		{
+			storage_ = std::move(map.storage_);
+			data_ = map.data_;
+			bytes_ = map.bytes_;
+			header_ = map.header_;
+			map.reset();
+		}
+
+		return *this;
+	}
+
+	// If a key repeats, its last value is kept.
+	template<typename InputIt>
+	static FrozenHashMap build(InputIt first, InputIt last, bool fingerprints = true);
+
+	template<typename F>
+	static FrozenHashMap build(const HashTable<K, V, F>& t, bool fingerprints = true);
+
+	// Map over a blob obtained from data(). Nothing is copied, so the
+	// memory must outlive the map.
+	static FrozenHashMap view(const void* data, size_t bytes);
+
+	const char* data() const { return data_; }
+	size_t bytes() const { return bytes_; }
+
+	bool find(const K& key, V& value) const;
+	bool contains(const K& key) const;
+
+	// Value of key, or V{} if it is not present.
+	V get(const K& key) const;
+
+	size_t size() const;
+
+	// Bits per key spent on the hash function (pilots and remap),
+	// i.e. excluding keys, values and fingerprints.
+	double bitsPerKey() const;
+
+private:
+	struct Header
+	{
+		char magic[8];
+		uint32_t keySize;
+		uint32_t valueSize;
+		uint64_t n;
+		uint64_t m;
+		uint64_t buckets;
+		uint64_t seed;
+		uint64_t fingerprints;
+	};
+
+	// Keys per bucket on average.
+	static const size_t lambda = 6;
+
+	static size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+	static uint64_t hash(const K& key, uint64_t seed) { return hashBytes(key, seed); }
+	static uint8_t fingerprint(uint64_t h) { return static_cast<uint8_t>(mix64(h ^ 0x5555555555555555ull) >> 56); }
+
+	static size_t bucket(uint64_t h, uint64_t buckets);
+	static size_t position(uint64_t h, uint16_t pilot, uint64_t m);
+
+	// x mod m without a division (Lemire's multiply-shift). Fine for
+	// well mixed x.
+	static uint64_t reduce(uint64_t x, uint64_t m)
+	{
+		return static_cast<uint64_t>((static_cast<unsigned __int128>(x) * m) >> 64);
+	}
+
+	// Size of the blob described by a header. The caller makes sure
+	// the counts are small enough not to overflow.
+	static size_t blobBytes(uint64_t n, uint64_t m, uint64_t buckets, bool fingerprints)
+	{
+		return sizeof(Header) + align8(buckets * sizeof(uint16_t)) +
+				align8((m - n) * sizeof(uint32_t)) + (fingerprints ? align8(n) : 0) +
+				align8(n * sizeof(Slot));
+	}
+
+	// Sections of the blob.
+	const uint16_t* pilots() const;
+	const uint32_t* remap() const;
+	const uint8_t* fingerprints() const;
+	const Slot* slots() const;
+
+	void attach(const char* data, size_t bytes);
+	void reset();
+
+	std::vector<uint64_t> storage_;
+	const char* data_;
+	size_t bytes_;
+	const Header* header_;
+};
+
+template<typename K, typename V>
+template<typename InputIt>
+FrozenHashMap<K, V> FrozenHashMap<K, V>::build(InputIt first, InputIt last, bool withFingerprints)
+{
+	// Last value wins: drop earlier duplicates.
+	std::vector<Slot> entries;
+
+	for (; first != last; ++first)
+	{
+		Slot s;
+		s.key = first->first;
+		s.value = first->second;
+		entries.push_back(s);
+	}
+
+	std::vector<size_t> order(entries.size());
+
+	for (size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+
+	auto byKey = [&entries](size_t a, size_t b)
+	{
+		int c = std::memcmp(&entries[a].key, &entries[b].key, sizeof(K));
+		return c < 0 || (c == 0 && a > b);
+	};
+
+	std::sort(order.begin(), order.end(), byKey);
+
+	std::vector<Slot> unique;
+
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		if (i == 0 || std::memcmp(&entries[order[i]].key, &unique.back().key, sizeof(K)) != 0)
+			unique.push_back(entries[order[i]]);
+	}
+
+	entries.swap(unique);
+
+	if (entries.size() > 0xFFFFFFFFull)
+		throw std::length_error("FrozenHashMap: 2^32 keys or more");
+
+	const uint64_t n = entries.size();
+	const uint64_t m = n + n / 100 + 1;
+	const uint64_t buckets = n / lambda + 1;
+
+	std::vector<uint64_t> hashes(n);
+	std::vector<uint16_t> pilot(buckets);
+	std::vector<uint64_t> slotOf(n);
+	uint64_t seed = 0;
+
+	// The pilot search tries many pilots per bucket.
+	std::vector<uint64_t> pilotHash(0x10000);
+
+	for (uint32_t p = 0; p <= 0xFFFF; ++p)
+		pilotHash[p] = mix64(p + 1);
+
+	// A seed fails if two keys collide on all 64 bits or a bucket needs
+	// a pilot above 16 bits. Both are rare; just try the next seed.
+	for (bool done = false; !done; ++seed)
+	{
+		if (seed == 100)
+			throw std::runtime_error("FrozenHashMap: cannot find a perfect hash");
+
+		for (size_t i = 0; i < n; ++i)
+			hashes[i] = hash(entries[i].key, seed);
+
+		// Keys grouped by bucket, biggest buckets first: they are the
+		// hardest to place, so place them while the table is empty.
+		std::vector<uint32_t> count(buckets, 0);
+		std::vector<size_t> byBucket(n);
+
+		for (size_t i = 0; i < n; ++i)
+			++count[bucket(hashes[i], buckets)];
+
+		std::vector<size_t> start(buckets + 1, 0);
+
+		for (size_t b = 0; b < buckets; ++b)
+			start[b + 1] = start[b] + count[b];
+
+		std::vector<size_t> fill(start.begin(), start.end() - 1);
+
+		for (size_t i = 0; i < n; ++i)
+			byBucket[fill[bucket(hashes[i], buckets)]++] = i;
+
+		std::vector<size_t> bucketOrder(buckets);
+
+		for (size_t b = 0; b < buckets; ++b)
+			bucketOrder[b] = b;
+
+		std::stable_sort(bucketOrder.begin(), bucketOrder.end(),
+				[&count](size_t a, size_t b){ return count[a] > count[b]; });
+
+		std::vector<bool> taken(m, false);
+		std::vector<uint64_t> positions;
+		done = true;
+
+		for (size_t b : bucketOrder)
+		{
+			if (count[b] == 0)
+				break;
+
+			bool placed = false;
+
+			for (uint32_t p = 0; p <= 0xFFFF && !placed; ++p)
+			{
+				positions.clear();
+				placed = true;
+
+				for (size_t k = start[b]; k < start[b + 1]; ++k)
+				{
+					uint64_t pos = reduce(hashes[byBucket[k]] ^ pilotHash[p], m);
+
+					if (taken[pos] || std::find(positions.begin(), positions.end(), pos) != positions.end())
+					{
+						placed = false;
+						break;
+					}
+
+					positions.push_back(pos);
+				}
+
+				if (placed)
+				{
+					pilot[b] = static_cast<uint16_t>(p);
+
+					for (size_t k = start[b]; k < start[b + 1]; ++k)
+					{
+						taken[positions[k - start[b]]] = true;
+						slotOf[byBucket[k]] = positions[k - start[b]];
+					}
+				}
+			}
+
+			if (!placed)
+			{
+				done = false;
+				break;
+			}
+		}
+
+		if (done)
+		{
+			// Remap: the slots >= n that are used go to the holes < n.
+			std::vector<uint32_t> remap(m - n, 0);
+			size_t hole = 0;
+
+			for (uint64_t pos = n; pos < m; ++pos)
+			{
+				if (!taken[pos])
+					continue;
+
+				while (taken[hole])
+					++hole;
+
+				remap[pos - n] = static_cast<uint32_t>(hole++);
+			}
+
+			// Lay out the blob.
+			size_t pilotsBytes = align8(buckets * sizeof(uint16_t));
+			size_t remapBytes = align8((m - n) * sizeof(uint32_t));
+			size_t fingerprintBytes = withFingerprints ? align8(n) : 0;
+			size_t total = blobBytes(n, m, buckets, withFingerprints);
+
+			FrozenHashMap map;
+			map.storage_.assign(total / 8, 0);
+
+			char* out = reinterpret_cast<char*>(map.storage_.data());
+			Header* h = reinterpret_cast<Header*>(out);
+
+			std::memcpy(h->magic, "FROZENM1", 8);
+			h->keySize = sizeof(K);
+			h->valueSize = sizeof(V);
+			h->n = n;
+			h->m = m;
+			h->buckets = buckets;
+			h->seed = seed;
+			h->fingerprints = withFingerprints;
+
+			char* p = out + sizeof(Header);
+			std::memcpy(p, pilot.data(), buckets * sizeof(uint16_t));
+			p += pilotsBytes;
+
+			std::memcpy(p, remap.data(), remap.size() * sizeof(uint32_t));
+			p += remapBytes;
+
+			uint8_t* fp = reinterpret_cast<uint8_t*>(p);
+			p += fingerprintBytes;
+
+			Slot* slots = reinterpret_cast<Slot*>(p);
+
+			for (size_t i = 0; i < n; ++i)
+			{
+				uint64_t pos = slotOf[i];
+
+				if (pos >= n)
+					pos = remap[pos - n];
+
+				slots[pos] = entries[i];
+
+				if (withFingerprints)
+					fp[pos] = fingerprint(hashes[i]);
+			}
+
+			map.attach(out, total);
+
+			return map;
+		}
+	}
+
+	return FrozenHashMap();
+}
+
+template<typename K, typename V>
+template<typename F>
+FrozenHashMap<K, V> FrozenHashMap<K, V>::build(const HashTable<K, V, F>& t, bool withFingerprints)
+{
+	std::vector<std::pair<K, V>> entries;
+	entries.reserve(t.size());
+
+	t.forEach([&entries](const K& key, const V& value){ entries.push_back(std::make_pair(key, value)); });
+
+	return build(entries.begin(), entries.end(), withFingerprints);
+}
+
+template<typename K, typename V>
+FrozenHashMap<K, V> FrozenHashMap<K, V>::view(const void* data, size_t bytes)
+{
+	const Header* h = static_cast<const Header*>(data);
+
+	if (bytes < sizeof(Header) || std::memcmp(h->magic, "FROZENM1", 8) != 0 ||
+		h->keySize != sizeof(K) || h->valueSize != sizeof(V))
+	{
+		throw std::runtime_error("FrozenHashMap: blob does not match the key/value types");
+	}
+
+	// Every section takes at least a byte per item it counts, so counts
+	// above bytes cannot fit and are rejected before they can overflow
+	// blobBytes().
+	if (h->m < h->n || h->n > 0xFFFFFFFFull || h->n > bytes || h->m - h->n > bytes || h->buckets > bytes ||
+		(h->n > 0 && h->buckets == 0) ||
+		bytes < blobBytes(h->n, h->m, h->buckets, h->fingerprints != 0))
+	{
+		throw std::runtime_error("FrozenHashMap: blob is truncated or corrupt");
+	}
+
+	FrozenHashMap map;
+	map.attach(static_cast<const char*>(data), bytes);
+
+	return map;
+}
+
+template<typename K, typename V>
+bool FrozenHashMap<K, V>::find(const K& key, V& value) const
+{
+	if (!header_ || header_->n == 0)
+		return false;
+
+	uint64_t h = hash(key, header_->seed);
+	uint64_t pos = position(h, pilots()[bucket(h, header_->buckets)], header_->m);
+
+	if (pos >= header_->n)
+		pos = remap()[pos - header_->n];
+
+	if (header_->fingerprints && fingerprints()[pos] != fingerprint(h))
+		return false;
+
+	const Slot& s = slots()[pos];
+
+	if (std::memcmp(&s.key, &key, sizeof(K)) != 0)
+		return false;
+
+	value = s.value;
+	return true;
+}
+
+template<typename K, typename V>
+bool FrozenHashMap<K, V>::contains(const K& key) const
+{
+	V value;
+	return find(key, value);
+}
+
+template<typename K, typename V>
+V FrozenHashMap<K, V>::get(const K& key) const
+{
+	V value{};
+	find(key, value);
+	return value;
+}
+
+template<typename K, typename V>
+size_t FrozenHashMap<K, V>::size() const
+{
+	return header_ ? header_->n : 0;
+}
+
+template<typename K, typename V>
+double FrozenHashMap<K, V>::bitsPerKey() const
+{
+	if (size() == 0)
+		return 0;
+
+	size_t bits = 8 * (header_->buckets * sizeof(uint16_t) + (header_->m - header_->n) * sizeof(uint32_t));
+
+	return static_cast<double>(bits) / header_->n;
+}
+
+/////////// Private Member Functions ///////////
+
+template<typename K, typename V>
+size_t FrozenHashMap<K, V>::bucket(uint64_t h, uint64_t buckets)
+{
+	// 60% of the keys into the first 30% of the buckets.
+	const uint64_t dense = (buckets * 3) / 10;
+	const uint64_t threshold = static_cast<uint64_t>(0.6 * 4294967296.0);
+	uint64_t hi = h >> 32;
+
+	if (hi < threshold && dense > 0)
+		return (h & 0xFFFFFFFF) % dense;
+
+	return dense + (h & 0xFFFFFFFF) % (buckets - dense);
+}
+
+template<typename K, typename V>
+size_t FrozenHashMap<K, V>::position(uint64_t h, uint16_t pilot, uint64_t m)
+{
+	return reduce(h ^ mix64(pilot + 1), m);
+}
+
+template<typename K, typename V>
+const uint16_t* FrozenHashMap<K, V>::pilots() const
+{
+	return reinterpret_cast<const uint16_t*>(data_ + sizeof(Header));
+}
+
+template<typename K, typename V>
+const uint32_t* FrozenHashMap<K, V>::remap() const
+{
+	return reinterpret_cast<const uint32_t*>(data_ + sizeof(Header) +
+			align8(header_->buckets * sizeof(uint16_t)));
+}
+
+template<typename K, typename V>
+const uint8_t* FrozenHashMap<K, V>::fingerprints() const
+{
+	return reinterpret_cast<const uint8_t*>(remap()) + align8((header_->m - header_->n) * sizeof(uint32_t));
+}
+
+template<typename K, typename V>
+const typename FrozenHashMap<K, V>::Slot* FrozenHashMap<K, V>::slots() const
+{
+	size_t fingerprintBytes = header_->fingerprints ? align8(header_->n) : 0;
+
+	return reinterpret_cast<const Slot*>(fingerprints() + fingerprintBytes);
+}
+
+template<typename K, typename V>
+void FrozenHashMap<K, V>::attach(const char* data, size_t bytes)
+{
+	data_ = data;
+	bytes_ = bytes;
+	header_ = reinterpret_cast<const Header*>(data);
+}
+
+template<typename K, typename V>
+void FrozenHashMap<K, V>::reset()
+{
+	storage_.clear();
+	data_ = nullptr;
+	bytes_ = 0;
+	header_ = nullptr;
+}
+
+#endif
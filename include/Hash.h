@@ -0,0 +1,55 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Hash functions with a fixed definition, for structures whose layout
+// is written to disk or to a blob and must not depend on std::hash.
+
+// Final avalanche of splitmix64: every input bit affects every output bit.
+inline uint64_t mix64(uint64_t h)
+{
+	h ^= h >> 30;
+	h *= 0xBF58476D1CE4E5B9ull;
+	h ^= h >> 27;
+	h *= 0x94D049BB133111EBull;
+	h ^= h >> 31;
+
+	return h;
+}
+
+// FNV-1a over n bytes. seed replaces the standard offset basis.
+inline uint64_t fnv1a64(const void* data, size_t n, uint64_t seed = 0xCBF29CE484222325ull)
+{
+	const unsigned char* p = static_cast<const unsigned char*>(data);
+	uint64_t h = seed;
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		h ^= p[i];
+		h *= 0x100000001B3ull;
+	}
+
+	return h;
+}
+
+// Hash of the object representation of key. Keys must not contain
+// padding, whose bytes are unspecified.
+template<typename K>
+inline uint64_t hashBytes(const K& key, uint64_t seed = 0xCBF29CE484222325ull)
+{
+	return mix64(fnv1a64(&key, sizeof(K), seed));
+}
+
+// hashBytes() as a function object.
+template<typename K>
+struct BytesHash
+{
+	uint64_t operator()(const K& key) const
+	{
+		return hashBytes(key);
+	}
+};
+
+#endif
@@ -5,6 +5,9 @@
 #include <utility>	// std::pair
 #include <algorithm>
 #include <iostream>
+#include <thread>
+
+#include "Stats.h"
 
 template<typename K>
 struct sampleHash
@@ -21,46 +24,321 @@ class HashTable
 {
 public:
 	HashTable(size_t size)
-		: table_(size)
+		: table_(size), size_(0)
 	{	}
 
 	V get(const K& key)
 	{
-		size_t hash = hashCode(key);
+		size_t hash = bucket(key);
 		
 		auto it = std::find_if(table_[hash].cbegin(), table_[hash].cend(), 
 						[&key](decltype(*(table_[hash].cbegin())) ele){ return ele.first == key;});
 
+		DS_STATS_ONLY(recordProbe(it - table_[hash].cbegin() + 1);)
+
 		return it->second; 	
 	}
 
+	// Pointer to the value of key, or nullptr.
+	V* find(const K& key)
+	{
+		size_t hash = bucket(key);
+
+		auto it = std::find_if(table_[hash].begin(), table_[hash].end(), 
+						[&key](decltype(*(table_[hash].cbegin())) ele){ return ele.first == key;});
+
+		DS_STATS_ONLY(recordProbe(it - table_[hash].begin() + (it != table_[hash].end()));)
+
+		return it != table_[hash].end() ? &it->second : nullptr;
+	}
+
+	bool contains(const K& key)
+	{
+		return find(key) != nullptr;
+	}
+
 	void put(const K& key, const V& value)
 	{
-		size_t hash = hashCode(key);
+		size_t hash = bucket(key);
 
-		if (hash >= 0 and hash < table_.size())
+		auto it = std::find_if(table_[hash].begin(), table_[hash].end(), 
+					[&key](decltype(*(table_[hash].cbegin())) ele){ return ele.first == key; });
+
+		DS_STATS_ONLY(recordProbe(it - table_[hash].begin() + (it != table_[hash].end()));)
+
+		if (it == table_[hash].end())
+		{
+			table_[hash].push_back(std::make_pair(key, value));
+			++size_;
+		}
+		else
 		{
-			auto it = std::find_if(table_[hash].begin(), table_[hash].end(), 
-						[&key](decltype(*(table_[hash].cbegin())) ele){ return ele.first == key; });
+			it->second = value;
+		}
+	}
+
+	// Returns false if key was not present. The last entry of the
+	// chain takes the place of the erased one.
+	bool erase(const K& key)
+	{
+		size_t hash = bucket(key);
+
+		auto it = std::find_if(table_[hash].begin(), table_[hash].end(), 
+					[&key](decltype(*(table_[hash].cbegin())) ele){ return ele.first == key; });
+
+		if (it == table_[hash].end())
+			return false;
+
+		*it = std::move(table_[hash].back());
+		table_[hash].pop_back();
+		--size_;
+
+		return true;
+	}
+
+	// Number of entries.
+	size_t size() const
+	{
+		return size_;
+	}
+
+	size_t bucketCount() const
+	{
+		return table_.size();
+	}
 
-			if (it == table_[hash].end())
+	// Calls f(key, value) for every entry, bucket by bucket.
+	template<typename Fn>
+	void forEach(Fn f) const
+	{
+		for (const auto& chain : table_)
+		{
+			for (const auto& ele : chain)
 			{
-				table_[hash].push_back(std::make_pair(key, value));
+				f(ele.first, ele.second);
 			}
-			else
+		}
+	}
+
+	// Writes the keys and the values as two columns, the i-th value
+	// belonging to the i-th key, and returns the number of entries.
+	// Each output needs room for size() elements.
+	template<typename KeyOut, typename ValueOut>
+	size_t exportTo(KeyOut keys, ValueOut values) const
+	{
+		for (const auto& chain : table_)
+		{
+			for (const auto& ele : chain)
 			{
-				it->second = value;
+				*keys++ = ele.first;
+				*values++ = ele.second;
 			}
 		}
-		else
+
+		return size_;
+	}
+
+	// Puts the n entries of two columns as written by exportTo(). The
+	// table is first rehashed to at least one bucket per entry. Then
+	// the keys are grouped by the thread that owns their bucket, and
+	// each thread fills its own range of buckets, so no locking is
+	// needed. As with put(), a later duplicate key wins. threads = 0
+	// uses every core. F must be safe to call from several threads.
+	void importFrom(const K* keys, const V* values, size_t n, size_t threads = 0)
+	{
+		if (size_ + n > table_.size())
+			rehash(size_ + n);
+
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+
+		threads = std::max<size_t>(1, std::min(threads, n / MinImportPerThread));
+
+		size_t buckets = table_.size();
+		auto owner = [buckets, threads](size_t b){ return b * threads / buckets; };
+
+		// Thread t hashes slice t of the input and counts the keys
+		// per owner.
+		std::vector<size_t> bucketOf(n);
+		std::vector<size_t> counts(threads * threads, 0);
+
+		parallel(threads, [&](size_t t)
 		{
-			// TODO
+			for (size_t i = n * t / threads; i < n * (t + 1) / threads; ++i)
+			{
+				bucketOf[i] = bucket(keys[i]);
+				++counts[t * threads + owner(bucketOf[i])];
+			}
+		});
+
+		// Group the input positions by owner, keeping the input order
+		// within a group.
+		std::vector<size_t> offsets(threads * threads);
+		std::vector<size_t> groups(threads + 1);
+		size_t sum = 0;
+
+		for (size_t o = 0; o < threads; ++o)
+		{
+			groups[o] = sum;
+
+			for (size_t t = 0; t < threads; ++t)
+			{
+				offsets[t * threads + o] = sum;
+				sum += counts[t * threads + o];
+			}
+		}
+
+		groups[threads] = sum;
+
+		std::vector<size_t> order(n);
+
+		parallel(threads, [&](size_t t)
+		{
+			for (size_t i = n * t / threads; i < n * (t + 1) / threads; ++i)
+			{
+				order[offsets[t * threads + owner(bucketOf[i])]++] = i;
+			}
+		});
+
+		std::vector<size_t> added(threads, 0);
+
+		parallel(threads, [&](size_t t)
+		{
+			// Presize the chains of buckets [first, last), so each grows
+			// at most once.
+			size_t first = (buckets * t + threads - 1) / threads;
+			size_t last = (buckets * (t + 1) + threads - 1) / threads;
+			std::vector<size_t> chainSize(last - first, 0);
+
+			for (size_t k = groups[t]; k < groups[t + 1]; ++k)
+			{
+				++chainSize[bucketOf[order[k]] - first];
+			}
+
+			for (size_t b = 0; b < chainSize.size(); ++b)
+			{
+				if (chainSize[b])
+					table_[first + b].reserve(table_[first + b].size() + chainSize[b]);
+			}
+
+			size_t count = 0;
+
+			for (size_t k = groups[t]; k < groups[t + 1]; ++k)
+			{
+				size_t i = order[k];
+				auto& chain = table_[bucketOf[i]];
+
+				auto it = std::find_if(chain.begin(), chain.end(),
+							[&](const std::pair<K, V>& ele){ return ele.first == keys[i]; });
+
+				if (it == chain.end())
+				{
+					chain.push_back(std::make_pair(keys[i], values[i]));
+					++count;
+				}
+				else
+				{
+					it->second = values[i];
+				}
+			}
+
+			added[t] = count;
+		});
+
+		for (size_t count : added)
+		{
+			size_ += count;
 		}
 	}
 
+	// Redistribute the entries over size buckets.
+	void rehash(size_t size)
+	{
+		std::vector<std::vector<std::pair<K, V>>> old(size);
+		old.swap(table_);
+
+		for (auto& chain : old)
+		{
+			for (auto& ele : chain)
+			{
+				table_[bucket(ele.first)].push_back(std::move(ele));
+			}
+		}
+
+		DS_STATS_ONLY(++counters_.resizes;)
+	}
+
+	// Chain lengths, load factor and memory always; probe and
+	// resize counters only when built with DS_STATS.
+	HashTableStats stats() const
+	{
+		HashTableStats s;
+
+#ifdef DS_STATS
+		s = counters_;
+#endif
+
+		s.buckets = table_.size();
+		s.entries = size_;
+		s.loadFactor = table_.empty() ? 0 : static_cast<double>(size_) / table_.size();
+		s.bytesAllocated = table_.capacity() * sizeof(table_[0]);
+
+		for (const auto& chain : table_)
+		{
+			recordHistogram(s.chainLengths, chain.size());
+			s.bytesAllocated += chain.capacity() * sizeof(chain[0]);
+		}
+
+		return s;
+	}
+
 private:
+#ifdef DS_STATS
+	void recordProbe(size_t probes)
+	{
+		++counters_.lookups;
+		counters_.probes += probes;
+		counters_.maxProbe = std::max(counters_.maxProbe, probes);
+	}
+
+	HashTableStats counters_;
+#endif
+
+	// Below this many entries per thread, importFrom() is faster on
+	// fewer threads.
+	static const size_t MinImportPerThread = 1 << 14;
+
+	// Runs f(0) .. f(threads - 1), f(0) on the calling thread.
+	template<typename Fn>
+	static void parallel(size_t threads, Fn f)
+	{
+		std::vector<std::thread> pool;
+
+		for (size_t t = 1; t < threads; ++t)
+		{
+			pool.emplace_back(f, t);
+		}
+
+		f(0);
+
+		for (auto& th : pool)
+		{
+			th.join();
+		}
+	}
+
+	// Hash codes larger than the table wrap around.
+	size_t bucket(const K& key)
+	{
+		return hashCode(key) % table_.size();
+	}
+
 	std::vector<std::vector<std::pair<K, V>>> table_;
+	size_t size_;
 	F hashCode;
+
+	// Interleaved lookups read the chains themselves.
+	friend class Interleaved;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,231 @@
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+#include <vector>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "HashTable.h"
+
+// A d-ary heap of keys by priority, with a HashTable from each key to
+// its place in the heap, so that a key can be found again to lower its
+// priority (decreaseKey(), as in Dijkstra or a scheduler) or to remove
+// it, in O(log n) instead of the O(n) search a plain heap needs.
+//
+// Keys are unique. top() has the priority that comes first under
+// Compare, the smallest with std::less. F hashes keys as in HashTable;
+// the table doubles whenever there are more keys than buckets.
+template<typename K, typename P, size_t D = 4, typename Compare = std::less<P>, typename F = sampleHash<K>>
+class IndexedHeap
+{
+	static_assert(D >= 2, "IndexedHeap needs at least two children per node");
+
+public:
+	explicit IndexedHeap(size_t expected = 16, Compare compare = Compare())
+		: positions_(expected ? expected : 1), compare_(compare)
+	{
+		heap_.reserve(expected);
+	}
+
+	// Bulk build from (key, priority) pairs with distinct keys, O(n).
+	template<typename InputIt>
+	IndexedHeap(InputIt first, InputIt last, Compare compare = Compare());
+
+	// Adds key; false, and no change, if it is already there.
+	bool push(const K& key, const P& priority);
+
+	const K& topKey() const
+	{
+		return heap_.front().first;
+	}
+
+	const P& topPriority() const
+	{
+		return heap_.front().second;
+	}
+
+	void pop()
+	{
+		removeAt(0);
+	}
+
+	bool contains(const K& key) const
+	{
+		return positions_.contains(key);
+	}
+
+	// Priority of key, which must be there.
+	const P& priority(const K& key) const
+	{
+		return heap_[positions_.get(key)].second;
+	}
+
+	// Gives key a priority that does not come after its current one.
+	// Returns false if key is not there.
+	bool decreaseKey(const K& key, const P& priority);
+
+	// Returns false if key is not there.
+	bool erase(const K& key)
+	{
+		size_t* position = positions_.find(key);
+
+		if (!position)
+			return false;
+
+		removeAt(*position);
+		return true;
+	}
+
+	size_t size() const
+	{
+		return heap_.size();
+	}
+
+	bool empty() const
+	{
+		return heap_.empty();
+	}
+
+private:
+	typedef std::pair<K, P> Item;
+
+	// Removes heap_[i]: the last item fills the hole and moves up or
+	// down from there.
+	void removeAt(size_t i);
+
+	void place(size_t i, Item item)
+	{
+		*positions_.find(item.first) = i;
+		heap_[i] = std::move(item);
+	}
+
+	void siftUp(size_t hole, Item item);
+	void siftDown(size_t hole, Item item);
+
+	std::vector<Item> heap_;
+
+	// HashTable lookups are not const.
+	mutable HashTable<K, size_t, F> positions_;
+	Compare compare_;
+};
+
+template<typename K, typename P, size_t D, typename Compare, typename F>
+template<typename InputIt>
+IndexedHeap<K, P, D, Compare, F>::IndexedHeap(InputIt first, InputIt last, Compare compare)
+	: heap_(first, last), positions_(heap_.empty() ? 1 : heap_.size()), compare_(compare)
+{
+	for (size_t i = 0; i < heap_.size(); ++i)
+	{
+		positions_.put(heap_[i].first, i);
+	}
+
+	if (heap_.size() < 2)
+		return;
+
+	for (size_t i = (heap_.size() - 2) / D + 1; i-- > 0; )
+	{
+		Item item = std::move(heap_[i]);
+		siftDown(i, std::move(item));
+	}
+}
+
+template<typename K, typename P, size_t D, typename Compare, typename F>
+bool IndexedHeap<K, P, D, Compare, F>::push(const K& key, const P& priority)
+{
+	if (positions_.contains(key))
+		return false;
+
+	positions_.put(key, heap_.size());
+
+	if (positions_.size() > positions_.bucketCount())
+		positions_.rehash(2 * positions_.bucketCount());
+
+	heap_.emplace_back(key, priority);
+	siftUp(heap_.size() - 1, heap_.back());
+
+	return true;
+}
+
+template<typename K, typename P, size_t D, typename Compare, typename F>
+bool IndexedHeap<K, P, D, Compare, F>::decreaseKey(const K& key, const P& priority)
+{
+	size_t* position = positions_.find(key);
+
+	if (!position)
+		return false;
+
+	size_t i = *position;
+
+	heap_[i].second = priority;
+	siftUp(i, std::move(heap_[i]));
+
+	return true;
+}
+
+template<typename K, typename P, size_t D, typename Compare, typename F>
+void IndexedHeap<K, P, D, Compare, F>::removeAt(size_t i)
+{
+	positions_.erase(heap_[i].first);
+
+	Item last = std::move(heap_.back());
+	heap_.pop_back();
+
+	if (i == heap_.size())
+		return;
+
+	if (i > 0 && compare_(last.second, heap_[(i - 1) / D].second))
+		siftUp(i, std::move(last));
+	else
+		siftDown(i, std::move(last));
+}
+
+template<typename K, typename P, size_t D, typename Compare, typename F>
+void IndexedHeap<K, P, D, Compare, F>::siftUp(size_t hole, Item item)
+{
+	while (hole > 0)
+	{
+		size_t parent = (hole - 1) / D;
+
+		if (!compare_(item.second, heap_[parent].second))
+			break;
+
+		place(hole, std::move(heap_[parent]));
+		hole = parent;
+	}
+
+	place(hole, std::move(item));
+}
+
+template<typename K, typename P, size_t D, typename Compare, typename F>
+void IndexedHeap<K, P, D, Compare, F>::siftDown(size_t hole, Item item)
+{
+	size_t n = heap_.size();
+
+	while (true)
+	{
+		size_t first = D * hole + 1;
+
+		if (first >= n)
+			break;
+
+		size_t last = first + D < n ? first + D : n;
+		size_t best = first;
+
+		for (size_t c = first + 1; c < last; ++c)
+		{
+			if (compare_(heap_[c].second, heap_[best].second))
+				best = c;
+		}
+
+		if (!compare_(heap_[best].second, item.second))
+			break;
+
+		place(hole, std::move(heap_[best]));
+		hole = best;
+	}
+
+	place(hole, std::move(item));
+}
+
+#endif
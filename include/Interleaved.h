@@ -0,0 +1,289 @@
+#ifndef INTERLEAVED_H
+#define INTERLEAVED_H
+
+// Needs C++20 coroutines; empty otherwise.
+#ifdef __cpp_impl_coroutine
+
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include "BinarySearchTree.h"
+#include "HashTable.h"
+
+// Interleaved execution of lookups. A lookup is a coroutine that, before
+// each node or bucket it reads, prefetches it and suspends. interleave()
+// keeps a batch of them in flight and resumes them in turn, so by the
+// time a lookup reads its node the line has had the other lookups' turns
+// to arrive. On structures much larger than the caches this overlaps
+// the misses of a batch instead of taking them one after the other.
+//
+// With everything in cache the suspensions are pure overhead; a plain
+// loop is faster there.
+class Interleaved
+{
+private:
+	// Frames of finished lookups, kept for the next ones: a batch would
+	// otherwise spend much of its time in malloc. One free list per
+	// frame size in 64-byte steps, per thread.
+	class FramePool
+	{
+	public:
+		~FramePool()
+		{
+			for (auto& list : free_)
+			{
+				for (void* frame : list)
+				{
+					::operator delete(frame);
+				}
+			}
+		}
+
+		void* allocate(size_t size)
+		{
+			size_t step = (size + 63) / 64;
+
+			if (step < Steps && !free_[step].empty())
+			{
+				void* frame = free_[step].back();
+				free_[step].pop_back();
+
+				return frame;
+			}
+
+			return ::operator new(step * 64);
+		}
+
+		void release(void* frame, size_t size)
+		{
+			size_t step = (size + 63) / 64;
+
+			if (step < Steps)
+				free_[step].push_back(frame);
+			else
+				::operator delete(frame);
+		}
+
+	private:
+		static const size_t Steps = 16;
+
+		std::vector<void*> free_[Steps];
+	};
+
+	static FramePool& frames()
+	{
+		static thread_local FramePool pool;
+
+		return pool;
+	}
+
+public:
+	// A suspended lookup that ends with a result of type R.
+	template<typename R>
+	class Lookup
+	{
+	public:
+		struct promise_type
+		{
+			R result{};
+
+			Lookup get_return_object()
+			{
+				return Lookup(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+
+			// Starts suspended, so that creating a batch costs no reads.
+			std::suspend_always initial_suspend() noexcept { return {}; }
+			std::suspend_always final_suspend() noexcept { return {}; }
+
+			void return_value(R r) { result = std::move(r); }
+			void unhandled_exception() { std::terminate(); }
+
+			static void* operator new(size_t size)
+			{
+				return frames().allocate(size);
+			}
+
+			static void operator delete(void* frame, size_t size)
+			{
+				frames().release(frame, size);
+			}
+		};
+
+		Lookup(Lookup&& l) noexcept
+			: handle_(std::exchange(l.handle_, nullptr))
+		{	}
+
+		Lookup& operator=(Lookup&& l) noexcept
+		{
+			if (this != &l)
+			{
+				if (handle_)
+					handle_.destroy();
+
+				handle_ = std::exchange(l.handle_, nullptr);
+			}
+
+			return *this;
+		}
+
+		Lookup(const Lookup&) = delete;
+		Lookup& operator=(const Lookup&) = delete;
+
+		~Lookup()
+		{
+			if (handle_)
+				handle_.destroy();
+		}
+
+		bool done() const
+		{
+			return handle_.done();
+		}
+
+		// Runs up to the next access, or to the end.
+		void resume()
+		{
+			handle_.resume();
+		}
+
+		const R& result() const
+		{
+			return handle_.promise().result;
+		}
+
+	private:
+		explicit Lookup(std::coroutine_handle<promise_type> handle)
+			: handle_(handle)
+		{	}
+
+		std::coroutine_handle<promise_type> handle_;
+	};
+
+	// co_await prefetch(p): starts loading p's line and lets the other
+	// lookups run.
+	struct prefetch
+	{
+		const void* address;
+
+		bool await_ready() const noexcept { return false; }
+
+		void await_suspend(std::coroutine_handle<>) const noexcept
+		{
+#ifdef __GNUC__
+			__builtin_prefetch(address);
+#endif
+		}
+
+		void await_resume() const noexcept {}
+	};
+
+	// Whether tree has key. The tree must outlive the lookup and not
+	// change meanwhile.
+	template<typename T>
+	static Lookup<bool> contains(const BinarySearchTree<T>& tree, T key)
+	{
+		const Node<T>* node = static_cast<const BinaryTree<T>&>(tree).root_;
+
+		while (node)
+		{
+			co_await prefetch{ node };
+
+			if (key < node->data)
+				node = node->left;
+			else if (node->data < key)
+				node = node->right;
+			else
+				co_return true;
+		}
+
+		co_return false;
+	}
+
+	// Pointer to the value of key, or nullptr: HashTable::find() in two
+	// steps, the bucket and then its chain. Same lifetime rules.
+	template<typename K, typename V, typename F>
+	static Lookup<V*> find(HashTable<K, V, F>& table, K key)
+	{
+		std::vector<std::pair<K, V>>& chain = table.table_[table.bucket(key)];
+
+		co_await prefetch{ &chain };
+
+		if (chain.empty())
+			co_return nullptr;
+
+		co_await prefetch{ chain.data() };
+
+		for (auto& entry : chain)
+		{
+			if (entry.first == key)
+				co_return &entry.second;
+		}
+
+		co_return nullptr;
+	}
+
+	// Runs the lookups start(0) to start(n - 1), at most width at a
+	// time, resuming them round robin; each finished one is reported as
+	// finish(i, result) and its place goes to the next. Results come in
+	// no particular order. A width of 0 counts as 1.
+	template<typename Start, typename Finish>
+	static void interleave(size_t n, size_t width, Start start, Finish finish);
+};
+
+template<typename Start, typename Finish>
+void Interleaved::interleave(size_t n, size_t width, Start start, Finish finish)
+{
+	typedef decltype(start(size_t(0))) Task;
+
+	width = std::max<size_t>(1, width);
+
+	std::vector<Task> running;
+	std::vector<size_t> ids;
+	size_t next = 0;
+
+	running.reserve(width);
+	ids.reserve(width);
+
+	while (next < n && running.size() < width)
+	{
+		running.push_back(start(next));
+		ids.push_back(next++);
+	}
+
+	while (!running.empty())
+	{
+		for (size_t slot = 0; slot < running.size(); )
+		{
+			running[slot].resume();
+
+			if (!running[slot].done())
+			{
+				++slot;
+				continue;
+			}
+
+			finish(ids[slot], running[slot].result());
+
+			if (next < n)
+			{
+				running[slot] = start(next);
+				ids[slot++] = next++;
+			}
+			else
+			{
+				running[slot] = std::move(running.back());
+				ids[slot] = ids.back();
+				running.pop_back();
+				ids.pop_back();
+			}
+		}
+	}
+}
+
+#endif
+
+#endif
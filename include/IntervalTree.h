@@ -0,0 +1,151 @@
+#ifndef INTERVALTREE_H
+#define INTERVALTREE_H
+
+#include <vector>
+
+#include "AugmentedTree.h"
+
+// Closed interval [lo, hi]. Ordered by lo, then hi.
+template<typename T>
+struct Interval
+{
+	T lo;
+	T hi;
+
+	bool overlaps(const T& from, const T& to) const
+	{
+		return !(to < lo) && !(hi < from);
+	}
+};
+
+template<typename T>
+bool operator<(const Interval<T>& lhs, const Interval<T>& rhs)
+{
+	return lhs.lo < rhs.lo || (!(rhs.lo < lhs.lo) && lhs.hi < rhs.hi);
+}
+
+template<typename T>
+bool operator==(const Interval<T>& lhs, const Interval<T>& rhs)
+{
+	return lhs.lo == rhs.lo && lhs.hi == rhs.hi;
+}
+
+// The summary of an interval tree: the largest hi in the subtree.
+template<typename T>
+struct MaxEndpoint
+{
+	typedef T value_type;
+
+	static T summarize(const Interval<T>& key, const T* left, const T* right)
+	{
+		T max = key.hi;
+
+		if (left && max < *left)
+			max = *left;
+
+		if (right && max < *right)
+			max = *right;
+
+		return max;
+	}
+};
+
+// Intervals in an AugmentedTree ordered by lo, each subtree knowing
+// its largest hi. A query skips a subtree whose largest hi is below
+// the window and everything right of a node that starts after it, so
+// it costs O(min(n, k log n)) for k results instead of a scan of all
+// n: each result may lie on its own root-to-leaf path.
+template<typename T>
+class IntervalTree
+{
+public:
+	IntervalTree() = default;
+
+	// Bulk build from a range of Interval<T>.
+	template<typename InputIt>
+	IntervalTree(InputIt first, InputIt last)
+		: tree_(first, last)
+	{	}
+
+	void insert(const T& lo, const T& hi)
+	{
+		tree_.insert(Interval<T>{ lo, hi });
+	}
+
+	// Removes one [lo, hi]; false if there is none.
+	bool erase(const T& lo, const T& hi)
+	{
+		return tree_.erase(Interval<T>{ lo, hi });
+	}
+
+	size_t size() const
+	{
+		return tree_.size();
+	}
+
+	size_t height() const
+	{
+		return tree_.height();
+	}
+
+	// Calls f(interval) for every interval overlapping [lo, hi], in no
+	// particular order.
+	template<typename F>
+	void overlap(const T& lo, const T& hi, F f) const;
+
+	// Calls f(interval) for every interval that contains point.
+	template<typename F>
+	void stab(const T& point, F f) const
+	{
+		overlap(point, point, f);
+	}
+
+	std::vector<Interval<T>> overlapping(const T& lo, const T& hi) const
+	{
+		std::vector<Interval<T>> v;
+
+		overlap(lo, hi, [&v](const Interval<T>& i) { v.push_back(i); });
+
+		return v;
+	}
+
+private:
+	AugmentedTree<Interval<T>, MaxEndpoint<T>> tree_;
+};
+
+template<typename T>
+template<typename F>
+void IntervalTree<T>::overlap(const T& lo, const T& hi, F f) const
+{
+	typedef Node<typename AugmentedTree<Interval<T>, MaxEndpoint<T>>::Entry> N;
+
+	std::vector<const N*> pending;
+
+	if (tree_.root())
+		pending.push_back(tree_.root());
+
+	while (!pending.empty())
+	{
+		const N* node = pending.back();
+		pending.pop_back();
+
+		// Nothing in this subtree reaches lo.
+		if (node->data.summary < lo)
+			continue;
+
+		if (node->left)
+			pending.push_back(node->left);
+
+		// This node and everything right of it start after hi.
+		if (hi < node->data.key.lo)
+			continue;
+
+		if (!(node->data.key.hi < lo))
+			f(node->data.key);
+
+		if (node->right)
+			pending.push_back(node->right);
+	}
+}
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef LEVELORDER_H
+#define LEVELORDER_H
+
+#include <vector>
+#include <iterator>
+#include <utility>
+#include <limits>
+
+#include "Node.h"
+
+// Level-order walk of a tree as a range of (level, node) pairs, the
+// root being level 0. Holds just two vectors, the current level and
+// the next one, which are swapped and reused from level to level: no
+// sentinels and no allocation per node.
+//
+// The range is single pass. Only the first maxLevels levels are
+// visited; the nodes below are never touched.
+template<typename T>
+class LevelOrder
+{
+public:
+	typedef std::pair<size_t, const Node<T>*> value_type;
+
+	class iterator
+	{
+	public:
+		typedef std::input_iterator_tag iterator_category;
+		typedef LevelOrder::value_type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const value_type* pointer;
+		typedef value_type reference;
+
+		explicit iterator(LevelOrder* walk = nullptr)
+			: walk_(walk)
+		{	}
+
+		value_type operator*() const
+		{
+			return value_type(walk_->level_, walk_->current_[walk_->index_]);
+		}
+
+		iterator& operator++()
+		{
+			walk_->advance();
+
+			if (walk_->done())
+				walk_ = nullptr;
+
+			return *this;
+		}
+
+		bool operator==(const iterator& rhs) const { return walk_ == rhs.walk_; }
+		bool operator!=(const iterator& rhs) const { return walk_ != rhs.walk_; }
+
+	private:
+		LevelOrder* walk_;
+	};
+
+	explicit LevelOrder(const Node<T>* root,
+			size_t maxLevels = std::numeric_limits<size_t>::max())
+		: index_(0), level_(0), maxLevels_(maxLevels)
+	{
+		if (root && maxLevels > 0)
+			current_.push_back(root);
+	}
+
+	iterator begin()
+	{
+		return iterator(done() ? nullptr : this);
+	}
+
+	iterator end()
+	{
+		return iterator();
+	}
+
+private:
+	bool done() const
+	{
+		return index_ == current_.size();
+	}
+
+	void advance()
+	{
+		const Node<T>* node = current_[index_++];
+
+		if (level_ + 1 < maxLevels_)
+		{
+			if (node->left)
+				next_.push_back(node->left);
+
+			if (node->right)
+				next_.push_back(node->right);
+		}
+
+		if (index_ == current_.size() && !next_.empty())
+		{
+			current_.swap(next_);
+			next_.clear();
+			index_ = 0;
+			++level_;
+		}
+	}
+
+	std::vector<const Node<T>*> current_;
+	std::vector<const Node<T>*> next_;
+	size_t index_;
+	size_t level_;
+	size_t maxLevels_;
+};
+
+#endif
@@ -1,12 +1,13 @@
 #ifndef NODE_H
 #define NODE_H
 
+// Links are non-owning. The nodes are owned by the tree's NodePool.
 template<typename T>
 struct Node
 {
 	T data;
-	std::shared_ptr<Node> left;
-	std::shared_ptr<Node> right;
+	Node* left;
+	Node* right;
 	
 	Node(const T& d) 
 		: data(d), left(nullptr), right(nullptr)
@@ -0,0 +1,129 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <deque>
+#include <vector>
+
+#include "Node.h"
+#include "Stats.h"
+
+// Owns all the nodes of a tree. Links between nodes are plain
+// non-owning pointers, so walking a tree never touches a reference
+// count and cycles (threads, lists) cannot leak.
+//
+// Nodes are kept in a std::deque, which never relocates existing
+// elements. Hence node addresses stay valid across create() and
+// across a move of the pool. Destroyed nodes are recycled through
+// a free list. splice() takes over the deques of another pool.
+template<typename T>
+class NodePool
+{
+public:
+	NodePool() = default;
+
+	NodePool(const NodePool&) = delete;
+	NodePool& operator=(const NodePool&) = delete;
+
+	NodePool(NodePool&&) = default;
+	NodePool& operator=(NodePool&&) = default;
+
+	~NodePool() = default;
+
+	Node<T>* create(const T& data)
+	{
+		DS_STATS_ONLY(++allocations_;)
+
+		if (!free_.empty())
+		{
+			Node<T>* node = free_.back();
+			free_.pop_back();
+
+			node->data = data;
+			node->left = nullptr;
+			node->right = nullptr;
+
+			return node;
+		}
+
+		nodes_.emplace_back(data);
+		return &nodes_.back();
+	}
+
+	void destroy(Node<T>* node)
+	{
+		DS_STATS_ONLY(++frees_;)
+
+		free_.push_back(node);
+	}
+
+	// Takes over the nodes of other, which keep their addresses, and
+	// leaves it empty. O(1) apart from appending other's free list.
+	void splice(NodePool&& other)
+	{
+		if (&other == this)
+			return;
+
+		chunks_.emplace_back();
+		chunks_.back().swap(other.nodes_);
+
+		for (auto& chunk : other.chunks_)
+		{
+			chunks_.emplace_back();
+			chunks_.back().swap(chunk);
+		}
+
+		free_.insert(free_.end(), other.free_.begin(), other.free_.end());
+
+		DS_STATS_ONLY(allocations_ += other.allocations_;)
+		DS_STATS_ONLY(frees_ += other.frees_;)
+
+		other.chunks_.clear();
+		other.free_.clear();
+		DS_STATS_ONLY(other.allocations_ = 0;)
+		DS_STATS_ONLY(other.frees_ = 0;)
+	}
+
+	void clear()
+	{
+		DS_STATS_ONLY(frees_ += size();)
+
+		nodes_.clear();
+		chunks_.clear();
+		free_.clear();
+	}
+
+	// Number of live nodes.
+	size_t size() const
+	{
+		size_t n = nodes_.size();
+
+		for (const auto& chunk : chunks_)
+		{
+			n += chunk.size();
+		}
+
+		return n - free_.size();
+	}
+
+	// Adds the allocation counters to s.
+	void stats(TreeStats& s) const
+	{
+#ifdef DS_STATS
+		s.allocations = allocations_;
+		s.frees = frees_;
+#endif
+		s.nodes = size();
+	}
+
+private:
+	std::deque<Node<T>> nodes_;
+	std::vector<Node<T>*> free_;
+
+	// Nodes taken over by splice().
+	std::vector<std::deque<Node<T>>> chunks_;
+
+	DS_STATS_ONLY(size_t allocations_ = 0;)
+	DS_STATS_ONLY(size_t frees_ = 0;)
+};
+
+#endif
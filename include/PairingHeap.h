@@ -0,0 +1,249 @@
+#ifndef PAIRINGHEAP_H
+#define PAIRINGHEAP_H
+
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "Node.h"
+#include "NodePool.h"
+
+// Pairing heap: a tree of nodes, each no later under Compare than its
+// children, kept as first child (left) and next sibling (right).
+// push(), merge() and decreaseKey() just link two trees, O(1); pop()
+// pairs up the root's children left to right and then folds the pairs
+// right to left, O(log n) amortized. top() is the first element under
+// Compare, the smallest with std::less.
+//
+// push() returns a handle that stays valid until its element is popped,
+// for decreaseKey().
+template<typename T, typename Compare = std::less<T>>
+class PairingHeap
+{
+	struct Entry
+	{
+		T value;
+		Node<Entry>* prev;	// parent if first child, else left sibling
+	};
+
+	typedef Node<Entry> N;
+
+public:
+	class Handle
+	{
+		friend class PairingHeap;
+
+	public:
+		Handle()
+			: node_(nullptr)
+		{	}
+
+	private:
+		explicit Handle(N* node)
+			: node_(node)
+		{	}
+
+		N* node_;
+	};
+
+	explicit PairingHeap(Compare compare = Compare())
+		: root_(nullptr), size_(0), compare_(compare)
+	{	}
+
+	// Bulk build: n - 1 links, O(n).
+	template<typename InputIt>
+	PairingHeap(InputIt first, InputIt last, Compare compare = Compare());
+
+	PairingHeap(const PairingHeap&) = delete;
+	PairingHeap& operator=(const PairingHeap&) = delete;
+
+	// Handles of a moved heap stay valid and belong to the new one.
+	PairingHeap(PairingHeap&& h)
+		: root_(h.root_), size_(h.size_), pool_(std::move(h.pool_)), compare_(std::move(h.compare_))
+	{
+		h.root_ = nullptr;
+		h.size_ = 0;
+	}
+
+	PairingHeap& operator=(PairingHeap&& h)
+	{
+		if (this != &h)
+		{
+			pool_ = std::move(h.pool_);
+			compare_ = std::move(h.compare_);
+			root_ = h.root_;
+			size_ = h.size_;
+			h.root_ = nullptr;
+			h.size_ = 0;
+		}
+
+		return *this;
+	}
+
+	Handle push(const T& value)
+	{
+		N* node = pool_.create(Entry{ value, nullptr });
+
+		root_ = root_ ? link(root_, node) : node;
+		++size_;
+
+		return Handle(node);
+	}
+
+	const T& top() const
+	{
+		return root_->data.value;
+	}
+
+	void pop();
+
+	// Gives the element of handle a value that does not come after its
+	// current one: its subtree is cut and linked with the root.
+	void decreaseKey(Handle handle, const T& value);
+
+	// Takes all of other's elements, whose handles stay valid. O(1).
+	void merge(PairingHeap&& other);
+
+	size_t size() const
+	{
+		return size_;
+	}
+
+	bool empty() const
+	{
+		return size_ == 0;
+	}
+
+private:
+	// Two roots into one: the later one becomes the first child.
+	N* link(N* a, N* b)
+	{
+		if (compare_(b->data.value, a->data.value))
+			std::swap(a, b);
+
+		b->right = a->left;
+
+		if (b->right)
+			b->right->data.prev = b;
+
+		b->data.prev = a;
+		a->left = b;
+		a->right = nullptr;
+
+		return a;
+	}
+
+	N* root_;
+	size_t size_;
+	NodePool<Entry> pool_;
+	Compare compare_;
+};
+
+template<typename T, typename Compare>
+template<typename InputIt>
+PairingHeap<T, Compare>::PairingHeap(InputIt first, InputIt last, Compare compare)
+	: root_(nullptr), size_(0), compare_(compare)
+{
+	for (; first != last; ++first)
+	{
+		push(*first);
+	}
+}
+
+template<typename T, typename Compare>
+void PairingHeap<T, Compare>::pop()
+{
+	N* old = root_;
+	N* child = old->left;
+
+	// First pass: link the children in pairs, left to right, and chain
+	// the results backwards through right.
+	N* pairs = nullptr;
+
+	while (child)
+	{
+		N* a = child;
+		N* b = a->right;
+
+		if (!b)
+		{
+			a->right = pairs;
+			pairs = a;
+			break;
+		}
+
+		child = b->right;
+		a->right = nullptr;
+		b->right = nullptr;
+
+		N* both = link(a, b);
+
+		both->right = pairs;
+		pairs = both;
+	}
+
+	// Second pass: fold them right to left.
+	N* result = nullptr;
+
+	while (pairs)
+	{
+		N* next = pairs->right;
+
+		pairs->right = nullptr;
+		result = result ? link(pairs, result) : pairs;
+		pairs = next;
+	}
+
+	if (result)
+		result->data.prev = nullptr;
+
+	root_ = result;
+	pool_.destroy(old);
+	--size_;
+}
+
+template<typename T, typename Compare>
+void PairingHeap<T, Compare>::decreaseKey(Handle handle, const T& value)
+{
+	N* node = handle.node_;
+
+	node->data.value = value;
+
+	if (node == root_)
+		return;
+
+	// Unhook node from its parent or left sibling.
+	N* prev = node->data.prev;
+
+	if (prev->left == node)
+		prev->left = node->right;
+	else
+		prev->right = node->right;
+
+	if (node->right)
+		node->right->data.prev = prev;
+
+	node->right = nullptr;
+	node->data.prev = nullptr;
+
+	root_ = link(root_, node);
+	root_->data.prev = nullptr;
+}
+
+template<typename T, typename Compare>
+void PairingHeap<T, Compare>::merge(PairingHeap&& other)
+{
+	if (&other == this || !other.root_)
+		return;
+
+	pool_.splice(std::move(other.pool_));
+
+	root_ = root_ ? link(root_, other.root_) : other.root_;
+	root_->data.prev = nullptr;
+	size_ += other.size_;
+
+	other.root_ = nullptr;
+	other.size_ = 0;
+}
+
+#endif
@@ -0,0 +1,671 @@
+#ifndef PERSISTENTHASHTABLE_H
+#define PERSISTENTHASHTABLE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Hash.h"
+
+// Hash table whose slots live in a memory-mapped file, for trivially
+// copyable keys and values. Opening is just an mmap, and processes that
+// open the same file read-only share it through the page cache.
+//
+// Layout of <path>: a Header, then an open-addressing (linear probing)
+// array of Slots. There are no pointers in the file; a slot is found by
+// its index, i.e. its offset from the start of the array.
+//
+// Updates are crash-safe:
+//   - put() appends a checksummed record to <path>.log and keeps the new
+//     value in memory. sync() makes the log durable.
+//   - checkpoint() writes a complete new table to <path>.tmp, fsyncs it
+//     and renames it over <path> (shadow paging), then empties the log.
+//   - Opening ReadWrite replays the log. A torn record at its tail, from
+//     a crash in the middle of an append, is dropped.
+// So <path> is always a complete table, and the log holds every synced
+// update made since it was written.
+//
+// Only one process may open a table ReadWrite (enforced with flock).
+// Readers keep the snapshot they mapped until they reopen.
+//
+// Keys are hashed and compared by their bytes, so they must not contain
+// padding.
+template<typename K, typename V>
+class PersistentHashTable
+{
+	static_assert(std::is_trivially_copyable<K>::value &&
+			std::is_trivially_copyable<V>::value,
+			"PersistentHashTable needs trivially copyable keys and values");
+
+public:
+	enum Mode { ReadOnly, ReadWrite };
+
+	// ReadWrite creates an empty table if path does not exist.
+	explicit PersistentHashTable(const std::string& path, Mode mode = ReadOnly);
+
+	PersistentHashTable(const PersistentHashTable&) = delete;
+	PersistentHashTable& operator=(const PersistentHashTable&) = delete;
+
+	// Flushes the log but does not checkpoint.
+	~PersistentHashTable();
+
+	// Writes a table holding [first, last) of (key, value) pairs to path
+	// in one go. This is the fast way to load a large data set. count is
+	// the number of pairs (at least the number of distinct keys).
+	template<typename InputIt>
+	static void build(const std::string& path, InputIt first, InputIt last, size_t count);
+
+	bool find(const K& key, V& value) const;
+	bool contains(const K& key) const;
+
+	// Value of key, or V{} if it is not present.
+	V get(const K& key) const;
+
+	void put(const K& key, const V& value);
+
+	// Makes every put() so far durable.
+	void sync();
+
+	// Folds the logged updates into a new table file.
+	void checkpoint();
+
+	size_t size() const;
+	size_t capacity() const;
+
+private:
+	struct Header
+	{
+		char magic[8];
+		uint32_t keySize;
+		uint32_t valueSize;
+		uint32_t slotSize;
+		uint32_t reserved;
+		uint64_t capacity;
+		uint64_t size;
+	};
+
+	struct Slot
+	{
+		K key;
+		V value;
+		unsigned char used;
+	};
+
+	// Slots start on their own cache line.
+	static const size_t slotsOffset = 64;
+
+	// Bytes of a log record: key, value and checksum.
+	static const size_t recordSize = sizeof(K) + sizeof(V) + sizeof(uint32_t);
+
+	struct KeyHash
+	{
+		size_t operator()(const K& key) const
+		{
+			return static_cast<size_t>(hash(key));
+		}
+	};
+
+	struct KeyEqual
+	{
+		bool operator()(const K& a, const K& b) const
+		{
+			return std::memcmp(&a, &b, sizeof(K)) == 0;
+		}
+	};
+
+	static uint64_t hash(const K& key);
+	static uint32_t checksum(const char* data, size_t n);
+
+	static size_t fileSize(size_t capacity);
+	static size_t capacityFor(size_t entries);
+
+	static Slot* slots(char* base);
+	static const Slot* slots(const char* base);
+
+	// Slot of key, or of the free slot where it would go.
+	static size_t probe(const Slot* s, size_t capacity, const K& key);
+	static bool insert(Slot* s, size_t capacity, const K& key, const V& value);
+
+	// Writes a new table file from header/slots and the overlay.
+	void writeTable(const std::string& path, size_t capacity) const;
+
+	void map();
+	void unmap();
+	void replay();
+	void flushLog();
+
+	// Makes a rename in path's directory durable.
+	static void syncDirectory(const std::string& path);
+
+	static void check(bool ok, const char* what);
+
+	std::string path_;
+	Mode mode_;
+	int fd_;
+	int logFd_;
+	char* base_;
+	size_t length_;
+
+	// Updates not yet checkpointed, and log bytes not yet written.
+	std::unordered_map<K, V, KeyHash, KeyEqual> overlay_;
+	size_t overlayNew_;
+	std::vector<char> logBuffer_;
+};
+
+template<typename K, typename V>
+const size_t PersistentHashTable<K, V>::slotsOffset;
+
+template<typename K, typename V>
+const size_t PersistentHashTable<K, V>::recordSize;
+
+template<typename K, typename V>
+PersistentHashTable<K, V>::PersistentHashTable(const std::string& path, Mode mode)
+	: path_(path), mode_(mode), fd_(-1), logFd_(-1), base_(nullptr), length_(0), overlayNew_(0)
+{
+	if (mode_ == ReadWrite)
+	{
+		std::string log = path_ + ".log";
+
+		logFd_ = ::open(log.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+		check(logFd_ >= 0, "open log");
+
+		if (::flock(logFd_, LOCK_EX | LOCK_NB) != 0)
+		{
+			::close(logFd_);
+			throw std::runtime_error("PersistentHashTable: " + path_ + " is already open for writing");
+		}
+
+		if (::access(path_.c_str(), F_OK) != 0)
+		{
+			std::vector<std::pair<K, V>> none;
+			build(path_, none.begin(), none.end(), 0);
+		}
+	}
+
+	try
+	{
+		map();
+
+		if (mode_ == ReadWrite)
+			replay();
+	}
+	catch (...)
+	{
+		unmap();
+
+		if (logFd_ >= 0)
+			::close(logFd_);
+
+		throw;
+	}
+}
+
+template<typename K, typename V>
+PersistentHashTable<K, V>::~PersistentHashTable()
+{
+	if (mode_ == ReadWrite)
+	{
+		// Destructors must not throw. A failed flush leaves the
+		// unsynced tail out of the log, as a crash would.
+		try
+		{
+			flushLog();
+		}
+		catch (...)
+		{
+		}
+
+		::close(logFd_);
+	}
+
+	unmap();
+}
+
+template<typename K, typename V>
+template<typename InputIt>
+void PersistentHashTable<K, V>::build(const std::string& path, InputIt first, InputIt last, size_t count)
+{
+	std::string tmp = path + ".tmp";
+	size_t capacity = capacityFor(count);
+	size_t length = fileSize(capacity);
+
+	int fd = ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	check(fd >= 0, "open");
+
+	// ftruncate gives zeroed (sparse) pages: all slots are free.
+	check(::ftruncate(fd, length) == 0, "ftruncate");
+
+	void* p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	check(p != MAP_FAILED, "mmap");
+
+	char* base = static_cast<char*>(p);
+	Header* h = reinterpret_cast<Header*>(base);
+	size_t size = 0;
+
+	for (; first != last; ++first)
+	{
+		if (insert(slots(base), capacity, first->first, first->second))
+			++size;
+	}
+
+	std::memcpy(h->magic, "PHTABLE1", 8);
+	h->keySize = sizeof(K);
+	h->valueSize = sizeof(V);
+	h->slotSize = sizeof(Slot);
+	h->reserved = 0;
+	h->capacity = capacity;
+	h->size = size;
+
+	check(::msync(base, length, MS_SYNC) == 0, "msync");
+	::munmap(base, length);
+	check(::fsync(fd) == 0, "fsync");
+	::close(fd);
+
+	check(::rename(tmp.c_str(), path.c_str()) == 0, "rename");
+	syncDirectory(path);
+}
+
+template<typename K, typename V>
+bool PersistentHashTable<K, V>::find(const K& key, V& value) const
+{
+	if (!overlay_.empty())
+	{
+		auto it = overlay_.find(key);
+
+		if (it != overlay_.end())
+		{
+			value = it->second;
+			return true;
+		}
+	}
+
+	const Slot* s = slots(base_);
+	size_t i = probe(s, capacity(), key);
+
+	if (i == capacity() || !s[i].used)
+		return false;
+
+	value = s[i].value;
+	return true;
+}
+
+template<typename K, typename V>
+bool PersistentHashTable<K, V>::contains(const K& key) const
+{
+	V value;
+	return find(key, value);
+}
+
+template<typename K, typename V>
+V PersistentHashTable<K, V>::get(const K& key) const
+{
+	V value{};
+	find(key, value);
+	return value;
+}
+
+template<typename K, typename V>
+void PersistentHashTable<K, V>::put(const K& key, const V& value)
+{
+	if (mode_ != ReadWrite)
+		throw std::logic_error("PersistentHashTable: put() on a read-only table");
+
+	size_t n = logBuffer_.size();
+	logBuffer_.resize(n + recordSize);
+
+	char* r = &logBuffer_[n];
+	std::memcpy(r, &key, sizeof(K));
+	std::memcpy(r + sizeof(K), &value, sizeof(V));
+
+	uint32_t sum = checksum(r, sizeof(K) + sizeof(V));
+	std::memcpy(r + sizeof(K) + sizeof(V), &sum, sizeof(sum));
+
+	if (!contains(key))
+		++overlayNew_;
+
+	overlay_[key] = value;
+
+	// Bound the buffer. Durability still needs sync().
+	if (logBuffer_.size() >= (1 << 20))
+		flushLog();
+}
+
+template<typename K, typename V>
+void PersistentHashTable<K, V>::sync()
+{
+	flushLog();
+	check(::fdatasync(logFd_) == 0, "fdatasync");
+}
+
+template<typename K, typename V>
+void PersistentHashTable<K, V>::checkpoint()
+{
+	if (mode_ != ReadWrite)
+		throw std::logic_error("PersistentHashTable: checkpoint() on a read-only table");
+
+	sync();
+
+	if (overlay_.empty())
+		return;
+
+	size_t newCapacity = capacity();
+
+	while (capacityFor(size()) > newCapacity)
+		newCapacity *= 2;
+
+	writeTable(path_, newCapacity);
+
+	unmap();
+	map();
+
+	overlay_.clear();
+	overlayNew_ = 0;
+
+	// A crash before this point replays records that are already in
+	// the table, which is harmless.
+	check(::ftruncate(logFd_, 0) == 0, "ftruncate log");
+	check(::fsync(logFd_) == 0, "fsync log");
+}
+
+template<typename K, typename V>
+size_t PersistentHashTable<K, V>::size() const
+{
+	return reinterpret_cast<const Header*>(base_)->size + overlayNew_;
+}
+
+template<typename K, typename V>
+size_t PersistentHashTable<K, V>::capacity() const
+{
+	return reinterpret_cast<const Header*>(base_)->capacity;
+}
+
+/////////// Private Member Functions ///////////
+
+template<typename K, typename V>
+uint64_t PersistentHashTable<K, V>::hash(const K& key)
+{
+	// Fixed, so files stay valid across builds.
+	return hashBytes(key);
+}
+
+template<typename K, typename V>
+uint32_t PersistentHashTable<K, V>::checksum(const char* data, size_t n)
+{
+	// FNV-1a. A zero filled tail does not checksum to zero.
+	uint32_t h = 0x811C9DC5u;
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		h ^= static_cast<unsigned char>(data[i]);
+		h *= 0x01000193u;
+	}
+
+	return h;
+}
+
+template<typename K, typename V>
+size_t PersistentHashTable<K, V>::fileSize(size_t capacity)
+{
+	return slotsOffset + capacity * sizeof(Slot);
+}
+
+template<typename K, typename V>
+size_t PersistentHashTable<K, V>::capacityFor(size_t entries)
+{
+	// Power of two, at most 70% full.
+	size_t capacity = 16;
+
+	while (entries * 10 > capacity * 7)
+		capacity *= 2;
+
+	return capacity;
+}
+
+template<typename K, typename V>
+typename PersistentHashTable<K, V>::Slot* PersistentHashTable<K, V>::slots(char* base)
+{
+	return reinterpret_cast<Slot*>(base + slotsOffset);
+}
+
+template<typename K, typename V>
+const typename PersistentHashTable<K, V>::Slot* PersistentHashTable<K, V>::slots(const char* base)
+{
+	return reinterpret_cast<const Slot*>(base + slotsOffset);
+}
+
+template<typename K, typename V>
+size_t PersistentHashTable<K, V>::probe(const Slot* s, size_t capacity, const K& key)
+{
+	size_t i = hash(key) & (capacity - 1);
+
+	for (size_t n = 0; n < capacity; ++n)
+	{
+		if (!s[i].used || KeyEqual()(s[i].key, key))
+			return i;
+
+		i = (i + 1) & (capacity - 1);
+	}
+
+	return capacity;
+}
+
+template<typename K, typename V>
+bool PersistentHashTable<K, V>::insert(Slot* s, size_t capacity, const K& key, const V& value)
+{
+	size_t i = probe(s, capacity, key);
+
+	if (i == capacity)
+		throw std::length_error("PersistentHashTable: table is full");
+
+	bool added = !s[i].used;
+
+	s[i].key = key;
+	s[i].value = value;
+	s[i].used = 1;
+
+	return added;
+}
+
+template<typename K, typename V>
+void PersistentHashTable<K, V>::writeTable(const std::string& path, size_t capacity) const
+{
+	// The current slots followed by the overlay. Same capacity means
+	// the slot array can be copied as is.
+	const Slot* old = slots(base_);
+	size_t oldCapacity = this->capacity();
+
+	std::vector<std::pair<K, V>> entries;
+
+	if (capacity != oldCapacity)
+	{
+		entries.reserve(size());
+
+		for (size_t i = 0; i < oldCapacity; ++i)
+		{
+			if (old[i].used)
+				entries.push_back(std::make_pair(old[i].key, old[i].value));
+		}
+
+		entries.insert(entries.end(), overlay_.begin(), overlay_.end());
+		build(path, entries.begin(), entries.end(), entries.size());
+
+		return;
+	}
+
+	std::string tmp = path + ".tmp";
+	size_t length = fileSize(capacity);
+
+	int fd = ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	check(fd >= 0, "open");
+	check(::ftruncate(fd, length) == 0, "ftruncate");
+
+	void* p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	check(p != MAP_FAILED, "mmap");
+
+	char* base = static_cast<char*>(p);
+	std::memcpy(base, base_, length);
+
+	Header* h = reinterpret_cast<Header*>(base);
+
+	for (const auto& ele : overlay_)
+	{
+		if (insert(slots(base), capacity, ele.first, ele.second))
+			++h->size;
+	}
+
+	check(::msync(base, length, MS_SYNC) == 0, "msync");
+	::munmap(base, length);
+	check(::fsync(fd) == 0, "fsync");
+	::close(fd);
+
+	check(::rename(tmp.c_str(), path.c_str()) == 0, "rename");
+	syncDirectory(path);
+}
+
+template<typename K, typename V>
+void PersistentHashTable<K, V>::map()
+{
+	fd_ = ::open(path_.c_str(), O_RDONLY);
+	check(fd_ >= 0, "open");
+
+	struct stat st;
+	check(::fstat(fd_, &st) == 0, "fstat");
+
+	length_ = st.st_size;
+
+	if (length_ < slotsOffset)
+		throw std::runtime_error("PersistentHashTable: " + path_ + " is not a table");
+
+	// The writer never modifies the mapped file in place (checkpoints
+	// write a new one), so everybody maps it read-only.
+	void* p = ::mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd_, 0);
+	check(p != MAP_FAILED, "mmap");
+
+	base_ = static_cast<char*>(p);
+
+	const Header* h = reinterpret_cast<const Header*>(base_);
+
+	if (std::memcmp(h->magic, "PHTABLE1", 8) != 0 ||
+		h->keySize != sizeof(K) || h->valueSize != sizeof(V) ||
+		h->slotSize != sizeof(Slot) || length_ != fileSize(h->capacity))
+	{
+		unmap();
+		throw std::runtime_error("PersistentHashTable: " + path_ + " does not match the key/value types");
+	}
+}
+
+template<typename K, typename V>
+void PersistentHashTable<K, V>::unmap()
+{
+	if (base_)
+		::munmap(base_, length_);
+
+	if (fd_ >= 0)
+		::close(fd_);
+
+	base_ = nullptr;
+	fd_ = -1;
+}
+
+template<typename K, typename V>
+void PersistentHashTable<K, V>::replay()
+{
+	off_t end = ::lseek(logFd_, 0, SEEK_END);
+	check(end >= 0, "lseek");
+
+	std::vector<char> log(end);
+	size_t done = 0;
+
+	while (done < log.size())
+	{
+		ssize_t n = ::pread(logFd_, &log[done], log.size() - done, done);
+		check(n > 0, "pread");
+		done += n;
+	}
+
+	size_t good = 0;
+
+	for (size_t off = 0; off + recordSize <= log.size(); off += recordSize)
+	{
+		const char* r = &log[off];
+		uint32_t sum;
+		std::memcpy(&sum, r + sizeof(K) + sizeof(V), sizeof(sum));
+
+		if (sum != checksum(r, sizeof(K) + sizeof(V)))
+			break;
+
+		K key;
+		V value;
+		std::memcpy(&key, r, sizeof(K));
+		std::memcpy(&value, r + sizeof(K), sizeof(V));
+
+		if (!contains(key))
+			++overlayNew_;
+
+		overlay_[key] = value;
+		good = off + recordSize;
+	}
+
+	// Drop a torn tail so new records follow the last good one.
+	if (good != log.size())
+	{
+		check(::ftruncate(logFd_, good) == 0, "ftruncate log");
+		check(::fsync(logFd_) == 0, "fsync log");
+	}
+}
+
+template<typename K, typename V>
+void PersistentHashTable<K, V>::flushLog()
+{
+	size_t done = 0;
+
+	while (done < logBuffer_.size())
+	{
+		ssize_t n = ::write(logFd_, &logBuffer_[done], logBuffer_.size() - done);
+
+		if (n < 0 && errno == EINTR)
+			continue;
+
+		check(n > 0, "write log");
+		done += n;
+	}
+
+	logBuffer_.clear();
+}
+
+template<typename K, typename V>
+void PersistentHashTable<K, V>::syncDirectory(const std::string& path)
+{
+	size_t slash = path.rfind('/');
+	std::string dir = (slash == std::string::npos) ? "." : path.substr(0, slash + 1);
+
+	int fd = ::open(dir.c_str(), O_RDONLY);
+
+	if (fd >= 0)
+	{
+		::fsync(fd);
+		::close(fd);
+	}
+}
+
+template<typename K, typename V>
+void PersistentHashTable<K, V>::check(bool ok, const char* what)
+{
+	if (!ok)
+		throw std::system_error(errno, std::generic_category(), std::string("PersistentHashTable: ") + what);
+}
+
+#endif
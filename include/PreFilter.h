@@ -0,0 +1,194 @@
+#ifndef PREFILTER_H
+#define PREFILTER_H
+
+#include <vector>
+#include <istream>
+
+#include "HashTable.h"
+#include "BinarySearchTree.h"
+
+// Containers with an approximate-membership filter in front of them.
+// A lookup asks the filter first and only searches the container when
+// the filter says "maybe", so most misses cost one filter probe
+// instead of a chain scan or a root-to-leaf walk.
+//
+// Any of BloomFilter, CuckooFilter and XorFilter can be used. The
+// filter only has to answer contains(key) and be constructible from a
+// range of keys; FilteredHashTable also needs insert(key).
+
+// HashTable whose find() and contains() check the filter first. A
+// filter that refuses an insert (a full CuckooFilter) can no longer
+// vouch for misses, so from then on every lookup goes to the table.
+//
+// The table is a private base: an insert that went around put() or
+// importFrom() would be missing from the filter and later reported
+// absent. Only the members that keep the two in step are exposed.
+template <typename K, typename V, typename Filter, typename F = sampleHash<K>>
+class FilteredHashTable : private HashTable<K, V, F>
+{
+	typedef HashTable<K, V, F> Base;
+
+public:
+	FilteredHashTable(size_t size, Filter filter)
+		: Base(size), filter_(std::move(filter)), bypass_(false)
+	{	}
+
+	using Base::get;
+	using Base::size;
+	using Base::bucketCount;
+	using Base::forEach;
+	using Base::exportTo;
+	using Base::rehash;
+	using Base::stats;
+
+	void put(const K& key, const V& value)
+	{
+		insertKey(key);
+		Base::put(key, value);
+	}
+
+	// The keys go into the filter one by one, then into the table in
+	// bulk as in HashTable::importFrom().
+	void importFrom(const K* keys, const V* values, size_t n, size_t threads = 0)
+	{
+		for (size_t i = 0; i < n && !bypass_; ++i)
+		{
+			insertKey(keys[i]);
+		}
+
+		Base::importFrom(keys, values, n, threads);
+	}
+
+	// Takes the key out of the filter too if the filter can erase
+	// (CuckooFilter), so that erasing and putting the same keys again
+	// does not fill it with stale copies. Other filters keep the key,
+	// which costs a false positive but never a false negative.
+	bool erase(const K& key)
+	{
+		if (!Base::erase(key))
+			return false;
+
+		if (!bypass_)
+			eraseFromFilter(filter_, key, 0);
+
+		return true;
+	}
+
+	V* find(const K& key)
+	{
+		return bypass_ || filter_.contains(key) ? Base::find(key) : nullptr;
+	}
+
+	bool contains(const K& key)
+	{
+		return find(key) != nullptr;
+	}
+
+	const Filter& filter() const
+	{
+		return filter_;
+	}
+
+private:
+	void insertKey(const K& key)
+	{
+		if (!bypass_ && !Base::contains(key) && !filter_.insert(key))
+			bypass_ = true;
+	}
+
+	// Picked when G has erase(key).
+	template<typename G>
+	static auto eraseFromFilter(G& filter, const K& key, int) -> decltype(filter.erase(key), void())
+	{
+		filter.erase(key);
+	}
+
+	template<typename G>
+	static void eraseFromFilter(G&, const K&, long)
+	{	}
+
+	Filter filter_;
+	bool bypass_;
+};
+
+// BinarySearchTree whose contains() checks the filter first. The tree
+// has no insert, so the filter is built from its keys on construction
+// and rebuilt by deserialize(); static filters such as XorFilter work.
+//
+// As above, the tree is a private base, so nothing can add or change
+// keys behind the filter's back: the set operations, split() and the
+// BinaryTree members that rewrite nodes are not available.
+template<typename T, typename Filter>
+class FilteredBinarySearchTree : private BinarySearchTree<T>
+{
+	typedef BinarySearchTree<T> Base;
+
+public:
+	FilteredBinarySearchTree(std::initializer_list<T> il)
+		: Base(il), filter_(makeFilter())
+	{	}
+
+	FilteredBinarySearchTree(std::vector<T> v)
+		: Base(std::move(v)), filter_(makeFilter())
+	{	}
+
+	using Base::serialize;
+	using Base::range;
+	using Base::countRange;
+
+	T min() const
+	{
+		return Base::min();
+	}
+
+	T max() const
+	{
+		return Base::max();
+	}
+
+	std::vector<T> inorder() const
+	{
+		return Base::inorder();
+	}
+
+	size_t size() const
+	{
+		return Base::size();
+	}
+
+	size_t height() const
+	{
+		return Base::height();
+	}
+
+	// The removed keys stay in the filter as false positives.
+	using Base::eraseRange;
+
+	bool contains(const T& data) const
+	{
+		return filter_.contains(data) && Base::contains(data);
+	}
+
+	void deserialize(std::istream& preorderStream)
+	{
+		Base::deserialize(preorderStream);
+		filter_ = makeFilter();
+	}
+
+	const Filter& filter() const
+	{
+		return filter_;
+	}
+
+private:
+	Filter makeFilter() const
+	{
+		std::vector<T> v = Base::inorder();
+
+		return Filter(v.begin(), v.end());
+	}
+
+	Filter filter_;
+};
+
+#endif
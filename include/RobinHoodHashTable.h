@@ -0,0 +1,287 @@
+#ifndef ROBINHOODHASHTABLE_H
+#define ROBINHOODHASHTABLE_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+
+#include "HashTable.h"	// sampleHash
+#include "Hash.h"
+#include "Stats.h"
+
+// Linear probing with Robin Hood insertion: a key that is further from
+// its home slot than the one it meets takes that slot, and the other
+// key moves on. Probe distances stay short and even, so the table runs
+// at a load factor of up to MaxLoad.
+//
+// Every slot stores its key's probe distance. A lookup stops as soon
+// as it meets a key closer to home than it would be, so a miss ends
+// early too. Erase shifts the following keys back by one instead of
+// leaving a tombstone, so a table under insert/erase churn looks the
+// same as a freshly built one.
+template <typename K, typename V, typename F = sampleHash<K>>
+class RobinHoodHashTable
+{
+public:
+	// Grow beyond this load factor, in percent.
+	static const size_t MaxLoad = 90;
+
+	// Room for at least size entries before the first resize.
+	explicit RobinHoodHashTable(size_t size = 16)
+		: slots_(slotsFor(size)), distance_(slotsFor(size), 0), size_(0)
+	{	}
+
+	// Value of key, or V{} if it is not present.
+	V get(const K& key) const
+	{
+		const V* v = find(key);
+
+		return v ? *v : V{};
+	}
+
+	const V* find(const K& key) const
+	{
+		size_t slot = lookup(key);
+
+		return slot != npos ? &slots_[slot].second : nullptr;
+	}
+
+	V* find(const K& key)
+	{
+		size_t slot = lookup(key);
+
+		return slot != npos ? &slots_[slot].second : nullptr;
+	}
+
+	bool contains(const K& key) const
+	{
+		return lookup(key) != npos;
+	}
+
+	void put(const K& key, const V& value)
+	{
+		size_t slot = lookup(key);
+
+		if (slot != npos)
+		{
+			slots_[slot].second = value;
+			return;
+		}
+
+		if ((size_ + 1) * 100 > slots_.size() * MaxLoad)
+			resize(slots_.size() * 2);
+
+		insert(std::make_pair(key, value));
+	}
+
+	// Returns false if key was not present.
+	bool erase(const K& key)
+	{
+		size_t slot = lookup(key);
+
+		if (slot == npos)
+			return false;
+
+		// Backward shift: pull every following displaced key one slot
+		// closer to home, up to an empty slot or a key already there.
+		size_t next = (slot + 1) & mask();
+
+		while (distance_[next] > 1)
+		{
+			slots_[slot] = std::move(slots_[next]);
+			distance_[slot] = distance_[next] - 1;
+
+			slot = next;
+			next = (next + 1) & mask();
+		}
+
+		distance_[slot] = 0;
+		--size_;
+
+		return true;
+	}
+
+	// Number of entries.
+	size_t size() const
+	{
+		return size_;
+	}
+
+	size_t bucketCount() const
+	{
+		return slots_.size();
+	}
+
+	double loadFactor() const
+	{
+		return static_cast<double>(size_) / slots_.size();
+	}
+
+	// Calls f(key, value) for every entry, slot by slot.
+	template<typename Fn>
+	void forEach(Fn f) const
+	{
+		for (size_t i = 0; i < slots_.size(); ++i)
+		{
+			if (distance_[i])
+				f(slots_[i].first, slots_[i].second);
+		}
+	}
+
+	// Same fields as HashTable::stats(). chainLengths[k] counts the
+	// entries k slots away from home.
+	HashTableStats stats() const
+	{
+		HashTableStats s;
+
+#ifdef DS_STATS
+		s = counters_;
+#endif
+
+		s.buckets = slots_.size();
+		s.entries = size_;
+		s.loadFactor = loadFactor();
+		s.bytesAllocated = slots_.capacity() * sizeof(slots_[0]) + distance_.capacity();
+
+		for (uint8_t d : distance_)
+		{
+			if (d)
+				recordHistogram(s.chainLengths, d - 1);
+		}
+
+		return s;
+	}
+
+private:
+	static const size_t npos = static_cast<size_t>(-1);
+
+	static size_t slotsFor(size_t size)
+	{
+		size_t n = 16;
+
+		while (n * MaxLoad < size * 100)
+			n *= 2;
+
+		return n;
+	}
+
+	size_t mask() const
+	{
+		return slots_.size() - 1;
+	}
+
+	size_t home(const K& key) const
+	{
+		return mix64(hashCode(key)) & mask();
+	}
+
+	// Slot of key, or npos.
+	size_t lookup(const K& key) const
+	{
+		size_t slot = home(key);
+
+		// distance_ is the probe distance plus one; 0 is an empty slot.
+		for (unsigned d = 1; ; ++d)
+		{
+			if (distance_[slot] < d)
+			{
+				DS_STATS_ONLY(recordProbe(d);)
+				return npos;
+			}
+
+			if (distance_[slot] == d && slots_[slot].first == key)
+			{
+				DS_STATS_ONLY(recordProbe(d);)
+				return slot;
+			}
+
+			slot = (slot + 1) & mask();
+		}
+	}
+
+	// entry's key is known not to be present and there is room.
+	void insert(std::pair<K, V> entry)
+	{
+		size_t slot = home(entry.first);
+		unsigned d = 1;
+
+		// Skip the keys at least as far from home as entry would be.
+		// Swapping entry with the first key closer to home, and so on
+		// down the run, moves every key up to the next empty slot on
+		// by one: do that as one shift instead.
+		while (distance_[slot] >= d)
+		{
+			slot = (slot + 1) & mask();
+			++d;
+		}
+
+		size_t end = slot;
+
+		while (distance_[end] && distance_[end] < 254)
+		{
+			end = (end + 1) & mask();
+		}
+
+		// A distance would no longer fit in a byte: the hash is
+		// clustering badly, so spread the keys out.
+		if (d == 255 || distance_[end])
+		{
+			resize(slots_.size() * 2);
+			insert(std::move(entry));
+			return;
+		}
+
+		for (size_t i = end; i != slot; )
+		{
+			size_t prev = (i - 1) & mask();
+
+			slots_[i] = std::move(slots_[prev]);
+			distance_[i] = distance_[prev] + 1;
+			i = prev;
+		}
+
+		slots_[slot] = std::move(entry);
+		distance_[slot] = static_cast<uint8_t>(d);
+		++size_;
+	}
+
+	void resize(size_t slots)
+	{
+		std::vector<std::pair<K, V>> old(slots);
+		std::vector<uint8_t> oldDistance(slots, 0);
+
+		old.swap(slots_);
+		oldDistance.swap(distance_);
+		size_ = 0;
+
+		for (size_t i = 0; i < old.size(); ++i)
+		{
+			if (oldDistance[i])
+				insert(std::move(old[i]));
+		}
+
+		DS_STATS_ONLY(++counters_.resizes;)
+	}
+
+#ifdef DS_STATS
+	void recordProbe(size_t probes) const
+	{
+		++counters_.lookups;
+		counters_.probes += probes;
+		counters_.maxProbe = std::max(counters_.maxProbe, probes);
+	}
+
+	mutable HashTableStats counters_;
+#endif
+
+	std::vector<std::pair<K, V>> slots_;
+	std::vector<uint8_t> distance_;
+	size_t size_;
+	mutable F hashCode;
+};
+
+template <typename K, typename V, typename F>
+const size_t RobinHoodHashTable<K, V, F>::MaxLoad;
+
+#endif
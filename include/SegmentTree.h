@@ -0,0 +1,249 @@
+#ifndef SEGMENTTREE_H
+#define SEGMENTTREE_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <iterator>
+
+// Aggregates for SegmentTree. Each is a monoid (identity, combine)
+// plus addTo(), the aggregate of count values after each one has
+// had delta added, which is what range add needs.
+template<typename T>
+struct SumOp
+{
+	static T identity() { return T{}; }
+	static T combine(const T& a, const T& b) { return a + b; }
+	static T addTo(const T& aggregate, const T& delta, size_t count) { return aggregate + delta * static_cast<T>(count); }
+};
+
+template<typename T>
+struct MinOp
+{
+	static T identity() { return std::numeric_limits<T>::max(); }
+	static T combine(const T& a, const T& b) { return std::min(a, b); }
+	static T addTo(const T& aggregate, const T& delta, size_t) { return aggregate + delta; }
+};
+
+template<typename T>
+struct MaxOp
+{
+	static T identity() { return std::numeric_limits<T>::lowest(); }
+	static T combine(const T& a, const T& b) { return std::max(a, b); }
+	static T addTo(const T& aggregate, const T& delta, size_t) { return aggregate + delta; }
+};
+
+// Array-backed segment tree over n values: point update, range query
+// and range add in O(log n). Node i has children 2i and 2i + 1 and
+// leaf j is node size_ + j, size_ being n rounded up to a power of two.
+//
+// Range adds are lazy: a node wholly inside the range takes the add
+// into its aggregate and keeps it in pending_ for its children, which
+// only get it when a later update goes below that node. Queries do
+// not push adds down; they add up the pending adds on their way down
+// and apply them to the aggregates they use, so they write nothing
+// and a const tree can be queried from several threads. Ranges are
+// half-open, [first, last), and cut at n; an index at or past n is
+// treated the same way.
+template<typename T, typename Op = SumOp<T>>
+class SegmentTree
+{
+public:
+	// n values, all T{}.
+	explicit SegmentTree(size_t n = 0);
+
+	// Built bottom up in O(n).
+	template<typename InputIt>
+	SegmentTree(InputIt first, InputIt last);
+
+	size_t size() const
+	{
+		return n_;
+	}
+
+	// Value at i; Op::identity() if i >= n.
+	T get(size_t i) const;
+
+	// Does nothing if i >= n.
+	void set(size_t i, const T& value);
+
+	// Op over [first, last); Op::identity() if the range is empty.
+	T query(size_t first, size_t last) const;
+
+	// Adds delta to every value in [first, last).
+	void add(size_t first, size_t last, const T& delta);
+
+private:
+	void build();
+
+	// Node node covers [lo, hi); carried is the sum of the adds pending
+	// above it.
+	T query(size_t node, size_t lo, size_t hi, size_t first, size_t last, const T& carried) const;
+	void add(size_t node, size_t lo, size_t hi, size_t first, size_t last, const T& delta);
+	void set(size_t node, size_t lo, size_t hi, size_t i, const T& value);
+
+	void apply(size_t node, size_t count, const T& delta)
+	{
+		tree_[node] = Op::addTo(tree_[node], delta, count);
+
+		if (node < size_)
+			pending_[node] += delta;
+	}
+
+	void pushDown(size_t node, size_t count)
+	{
+		if (pending_[node] == T{})
+			return;
+
+		apply(2 * node, count / 2, pending_[node]);
+		apply(2 * node + 1, count / 2, pending_[node]);
+
+		pending_[node] = T{};
+	}
+
+	size_t n_;
+	size_t size_;
+	std::vector<T> tree_;
+	std::vector<T> pending_;
+};
+
+template<typename T, typename Op>
+SegmentTree<T, Op>::SegmentTree(size_t n)
+	: n_(n), size_(1)
+{
+	while (size_ < n_)
+		size_ *= 2;
+
+	tree_.assign(2 * size_, Op::identity());
+	std::fill(tree_.begin() + size_, tree_.begin() + size_ + n_, T{});
+	build();
+}
+
+template<typename T, typename Op>
+template<typename InputIt>
+SegmentTree<T, Op>::SegmentTree(InputIt first, InputIt last)
+	: n_(0), size_(1)
+{
+	std::vector<T> values(first, last);
+
+	n_ = values.size();
+
+	while (size_ < n_)
+		size_ *= 2;
+
+	tree_.assign(2 * size_, Op::identity());
+	std::copy(values.begin(), values.end(), tree_.begin() + size_);
+	build();
+}
+
+template<typename T, typename Op>
+void SegmentTree<T, Op>::build()
+{
+	for (size_t i = size_ - 1; i > 0; --i)
+	{
+		tree_[i] = Op::combine(tree_[2 * i], tree_[2 * i + 1]);
+	}
+
+	pending_.assign(size_, T{});
+}
+
+template<typename T, typename Op>
+T SegmentTree<T, Op>::get(size_t i) const
+{
+	if (i >= n_)
+		return Op::identity();
+
+	return query(1, 0, size_, i, i + 1, T{});
+}
+
+template<typename T, typename Op>
+void SegmentTree<T, Op>::set(size_t i, const T& value)
+{
+	if (i < n_)
+		set(1, 0, size_, i, value);
+}
+
+template<typename T, typename Op>
+T SegmentTree<T, Op>::query(size_t first, size_t last) const
+{
+	last = std::min(last, n_);
+
+	if (first >= last)
+		return Op::identity();
+
+	return query(1, 0, size_, first, last, T{});
+}
+
+template<typename T, typename Op>
+void SegmentTree<T, Op>::add(size_t first, size_t last, const T& delta)
+{
+	last = std::min(last, n_);
+
+	if (first < last)
+		add(1, 0, size_, first, last, delta);
+}
+
+template<typename T, typename Op>
+T SegmentTree<T, Op>::query(size_t node, size_t lo, size_t hi, size_t first, size_t last,
+		const T& carried) const
+{
+	if (first <= lo && hi <= last)
+		return carried == T{} ? tree_[node] : Op::addTo(tree_[node], carried, hi - lo);
+
+	T below = carried + pending_[node];
+	size_t mid = lo + (hi - lo) / 2;
+	T result = Op::identity();
+
+	if (first < mid)
+		result = query(2 * node, lo, mid, first, last, below);
+
+	if (mid < last)
+		result = Op::combine(result, query(2 * node + 1, mid, hi, first, last, below));
+
+	return result;
+}
+
+template<typename T, typename Op>
+void SegmentTree<T, Op>::add(size_t node, size_t lo, size_t hi, size_t first, size_t last, const T& delta)
+{
+	if (first <= lo && hi <= last)
+	{
+		apply(node, hi - lo, delta);
+		return;
+	}
+
+	pushDown(node, hi - lo);
+
+	size_t mid = lo + (hi - lo) / 2;
+
+	if (first < mid)
+		add(2 * node, lo, mid, first, last, delta);
+
+	if (mid < last)
+		add(2 * node + 1, mid, hi, first, last, delta);
+
+	tree_[node] = Op::combine(tree_[2 * node], tree_[2 * node + 1]);
+}
+
+template<typename T, typename Op>
+void SegmentTree<T, Op>::set(size_t node, size_t lo, size_t hi, size_t i, const T& value)
+{
+	if (hi - lo == 1)
+	{
+		tree_[node] = value;
+		return;
+	}
+
+	pushDown(node, hi - lo);
+
+	size_t mid = lo + (hi - lo) / 2;
+
+	if (i < mid)
+		set(2 * node, lo, mid, i, value);
+	else
+		set(2 * node + 1, mid, hi, i, value);
+
+	tree_[node] = Op::combine(tree_[2 * node], tree_[2 * node + 1]);
+}
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef SHARDEDCACHE_H
+#define SHARDEDCACHE_H
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <mutex>
+
+#include "Cache.h"
+
+// Thread-safe Cache: the keys are split over shards by hash, each a
+// Cache behind its own mutex, so threads working on different keys
+// rarely wait for each other. The capacity is split evenly, hence the
+// eviction order is per shard.
+template <typename K, typename V, typename Policy = LruPolicy, typename F = sampleHash<K>>
+class ShardedCache
+{
+public:
+	// capacity must be at least 1. The shards' capacities add up to it
+	// exactly: the first capacity % shards shards get one entry more,
+	// and there are no more shards than entries.
+	explicit ShardedCache(size_t capacity, size_t shards = 16)
+	{
+		shards = std::max<size_t>(1, std::min(shards, capacity));
+
+		for (size_t s = 0; s < shards; ++s)
+		{
+			shards_.emplace_back(new Shard(capacity / shards + (s < capacity % shards)));
+		}
+	}
+
+	// Copies the value out, since a pointer into the shard would not
+	// outlive the lock.
+	bool get(const K& key, V& value)
+	{
+		Shard& s = shard(key);
+		std::lock_guard<std::mutex> lock(s.mutex);
+
+		V* v = s.cache.get(key);
+
+		if (!v)
+			return false;
+
+		value = *v;
+
+		return true;
+	}
+
+	void put(const K& key, const V& value)
+	{
+		Shard& s = shard(key);
+		std::lock_guard<std::mutex> lock(s.mutex);
+
+		s.cache.put(key, value);
+	}
+
+	bool erase(const K& key)
+	{
+		Shard& s = shard(key);
+		std::lock_guard<std::mutex> lock(s.mutex);
+
+		return s.cache.erase(key);
+	}
+
+	size_t size()
+	{
+		size_t n = 0;
+
+		for (auto& s : shards_)
+		{
+			std::lock_guard<std::mutex> lock(s->mutex);
+			n += s->cache.size();
+		}
+
+		return n;
+	}
+
+	size_t capacity() const
+	{
+		size_t n = 0;
+
+		for (auto& s : shards_)
+		{
+			n += s->cache.capacity();
+		}
+
+		return n;
+	}
+
+	// Sum over the shards.
+	CacheStats stats()
+	{
+		CacheStats total;
+
+		for (auto& s : shards_)
+		{
+			std::lock_guard<std::mutex> lock(s->mutex);
+			total += s->cache.stats();
+		}
+
+		return total;
+	}
+
+private:
+	// Allocated one by one, so two shards' mutexes do not share a
+	// cache line.
+	struct Shard
+	{
+		explicit Shard(size_t capacity)
+			: cache(capacity)
+		{	}
+
+		std::mutex mutex;
+		Cache<K, V, Policy, F> cache;
+	};
+
+	// Mixed, so that the shard does not depend on the bucket the
+	// key gets in the shard's HashTable.
+	Shard& shard(const K& key)
+	{
+		return *shards_[(mix64(F()(key)) >> 32) % shards_.size()];
+	}
+
+	std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <vector>
+#include <iostream>
+
+// Hot-path counters are compiled in only when DS_STATS is defined
+// (e.g. -DDS_STATS). Without it the containers carry no counters and
+// stats() reports just what can be derived from the structure itself.
+#ifdef DS_STATS
+#define DS_STATS_ONLY(...) __VA_ARGS__
+#else
+#define DS_STATS_ONLY(...)
+#endif
+
+// Histogram: h[k] counts the events of size k.
+inline void recordHistogram(std::vector<size_t>& h, size_t k)
+{
+	if (h.size() <= k)
+		h.resize(k + 1, 0);
+
+	++h[k];
+}
+
+inline void dumpHistogram(std::ostream& out, const std::vector<size_t>& h)
+{
+	for (size_t k = 0; k < h.size(); ++k)
+	{
+		if (h[k])
+			out << "  " << k << ": " << h[k] << "\n";
+	}
+}
+
+struct HashTableStats
+{
+	size_t buckets = 0;
+	size_t entries = 0;
+	double loadFactor = 0;
+
+	// chainLengths[k] is the number of buckets holding k entries.
+	std::vector<size_t> chainLengths;
+
+	// Bytes held by the bucket array and the chains.
+	size_t bytesAllocated = 0;
+
+	// Counted only with DS_STATS. A probe is one entry compared.
+	size_t lookups = 0;
+	size_t probes = 0;
+	size_t maxProbe = 0;
+	size_t resizes = 0;
+
+	double averageProbe() const
+	{
+		return lookups ? static_cast<double>(probes) / lookups : 0;
+	}
+
+	void dump(std::ostream& out) const
+	{
+		out << "buckets: " << buckets << "\n"
+			<< "entries: " << entries << "\n"
+			<< "load factor: " << loadFactor << "\n"
+			<< "bytes allocated: " << bytesAllocated << "\n"
+			<< "lookups: " << lookups << "\n"
+			<< "average probe: " << averageProbe() << "\n"
+			<< "max probe: " << maxProbe << "\n"
+			<< "resizes: " << resizes << "\n"
+			<< "chain lengths:\n";
+
+		dumpHistogram(out, chainLengths);
+	}
+};
+
+struct TreeStats
+{
+	size_t nodes = 0;
+	size_t height = 0;
+
+	// Counted only with DS_STATS.
+	size_t allocations = 0;
+	size_t frees = 0;
+	size_t searches = 0;
+
+	// searchDepths[k] is the number of searches that visited k nodes.
+	std::vector<size_t> searchDepths;
+
+	void dump(std::ostream& out) const
+	{
+		out << "nodes: " << nodes << "\n"
+			<< "height: " << height << "\n"
+			<< "allocations: " << allocations << "\n"
+			<< "frees: " << frees << "\n"
+			<< "searches: " << searches << "\n"
+			<< "search depths:\n";
+
+		dumpHistogram(out, searchDepths);
+	}
+};
+
+// Always counted: a cache's hit rate is part of what it reports.
+struct CacheStats
+{
+	size_t hits = 0;
+	size_t misses = 0;
+	size_t inserts = 0;
+	size_t evictions = 0;
+
+	double hitRate() const
+	{
+		return hits + misses ? static_cast<double>(hits) / (hits + misses) : 0;
+	}
+
+	CacheStats& operator+=(const CacheStats& s)
+	{
+		hits += s.hits;
+		misses += s.misses;
+		inserts += s.inserts;
+		evictions += s.evictions;
+
+		return *this;
+	}
+
+	void dump(std::ostream& out) const
+	{
+		out << "hits: " << hits << "\n"
+			<< "misses: " << misses << "\n"
+			<< "hit rate: " << hitRate() << "\n"
+			<< "inserts: " << inserts << "\n"
+			<< "evictions: " << evictions << "\n";
+	}
+};
+
+#endif
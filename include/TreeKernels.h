@@ -0,0 +1,207 @@
+#ifndef TREEKERNELS_H
+#define TREEKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define DS_HAVE_AVX2_KERNELS
+#endif
+
+// Kernels over the arrays of an array-backed tree (FlatBinaryTree):
+// keys plus 32-bit child indices, with 0xFFFFFFFF for "no child".
+//
+// Each has a scalar version for any key type and an AVX2 version for
+// int keys. The AVX2 code is compiled with a target attribute, so no
+// -mavx2 is needed, and only runs if the CPU has AVX2; the choice is
+// made once per process.
+
+namespace kernels
+{
+
+const uint32_t nil = 0xFFFFFFFF;
+
+inline bool hasAvx2()
+{
+#ifdef DS_HAVE_AVX2_KERNELS
+	static const bool avx2 = __builtin_cpu_supports("avx2");
+
+	return avx2;
+#else
+	return false;
+#endif
+}
+
+/////////// Scalar ///////////
+
+// v[0] < v[1] < ... < v[n - 1].
+template<typename T>
+bool isStrictlyIncreasingScalar(const T* v, size_t n)
+{
+	for (size_t i = 1; i < n; ++i)
+	{
+		if (!(v[i - 1] < v[i]))
+			return false;
+	}
+
+	return true;
+}
+
+// Number of nodes without children.
+inline size_t leafCountScalar(const uint32_t* left, const uint32_t* right, size_t n)
+{
+	size_t count = 0;
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		count += (left[i] & right[i]) == nil;
+	}
+
+	return count;
+}
+
+// Every node with a child equals the sum of its children's keys, a
+// missing child counting as T{}. Checks nodes [first, n).
+template<typename T>
+bool isSumPropertyScalar(const T* keys, const uint32_t* left, const uint32_t* right,
+		size_t n, size_t first = 0)
+{
+	for (size_t i = first; i < n; ++i)
+	{
+		if (left[i] == nil && right[i] == nil)
+			continue;
+
+		T leftValue = left[i] != nil ? keys[left[i]] : T{};
+		T rightValue = right[i] != nil ? keys[right[i]] : T{};
+
+		if (!(keys[i] == leftValue + rightValue))
+			return false;
+	}
+
+	return true;
+}
+
+/////////// AVX2, int keys ///////////
+
+#ifdef DS_HAVE_AVX2_KERNELS
+
+// Eight neighbouring pairs per compare.
+__attribute__((target("avx2")))
+inline bool isStrictlyIncreasingAvx2(const int* v, size_t n)
+{
+	size_t i = 0;
+
+	for (; i + 8 < n; i += 8)
+	{
+		__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i));
+		__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i + 1));
+
+		if (_mm256_movemask_epi8(_mm256_cmpgt_epi32(b, a)) != -1)
+			return false;
+	}
+
+	return isStrictlyIncreasingScalar(v + i, n - i);
+}
+
+// A leaf has both indices equal to nil, i.e. their and is all ones.
+__attribute__((target("avx2,popcnt")))
+inline size_t leafCountAvx2(const uint32_t* left, const uint32_t* right, size_t n)
+{
+	const __m256i ones = _mm256_set1_epi32(-1);
+	size_t count = 0;
+	size_t i = 0;
+
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + i));
+		__m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + i));
+		__m256i leaf = _mm256_cmpeq_epi32(_mm256_and_si256(l, r), ones);
+
+		count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(leaf)));
+	}
+
+	return count + leafCountScalar(left + i, right + i, n - i);
+}
+
+// Eight nodes at a time in storage (level) order, the children's keys
+// fetched with masked gathers. Indices are used as signed 32-bit
+// offsets, hence n must stay below 2^31.
+__attribute__((target("avx2")))
+inline bool isSumPropertyAvx2(const int* keys, const uint32_t* left, const uint32_t* right, size_t n)
+{
+	const __m256i ones = _mm256_set1_epi32(-1);
+	const __m256i zero = _mm256_setzero_si256();
+	size_t i = 0;
+
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+		__m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + i));
+		__m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + i));
+
+		__m256i hasLeft = _mm256_xor_si256(_mm256_cmpeq_epi32(l, ones), ones);
+		__m256i hasRight = _mm256_xor_si256(_mm256_cmpeq_epi32(r, ones), ones);
+
+		__m256i lv = _mm256_mask_i32gather_epi32(zero, keys, l, hasLeft, 4);
+		__m256i rv = _mm256_mask_i32gather_epi32(zero, keys, r, hasRight, 4);
+
+		__m256i sum = _mm256_cmpeq_epi32(k, _mm256_add_epi32(lv, rv));
+		__m256i leaf = _mm256_xor_si256(_mm256_or_si256(hasLeft, hasRight), ones);
+
+		if (_mm256_movemask_epi8(_mm256_or_si256(sum, leaf)) != -1)
+			return false;
+	}
+
+	return isSumPropertyScalar(keys, left, right, n, i);
+}
+
+#endif
+
+/////////// Dispatch ///////////
+
+template<typename T>
+bool isStrictlyIncreasing(const T* v, size_t n)
+{
+	return isStrictlyIncreasingScalar(v, n);
+}
+
+inline bool isStrictlyIncreasing(const int* v, size_t n)
+{
+#ifdef DS_HAVE_AVX2_KERNELS
+	if (hasAvx2())
+		return isStrictlyIncreasingAvx2(v, n);
+#endif
+
+	return isStrictlyIncreasingScalar(v, n);
+}
+
+inline size_t leafCount(const uint32_t* left, const uint32_t* right, size_t n)
+{
+#ifdef DS_HAVE_AVX2_KERNELS
+	if (hasAvx2())
+		return leafCountAvx2(left, right, n);
+#endif
+
+	return leafCountScalar(left, right, n);
+}
+
+template<typename T>
+bool isSumProperty(const T* keys, const uint32_t* left, const uint32_t* right, size_t n)
+{
+	return isSumPropertyScalar(keys, left, right, n);
+}
+
+inline bool isSumProperty(const int* keys, const uint32_t* left, const uint32_t* right, size_t n)
+{
+#ifdef DS_HAVE_AVX2_KERNELS
+	if (hasAvx2() && n < (size_t(1) << 31))
+		return isSumPropertyAvx2(keys, left, right, n);
+#endif
+
+	return isSumPropertyScalar(keys, left, right, n);
+}
+
+}
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef TREELIST_H
+#define TREELIST_H
+
+#include <iterator>
+#include <cstddef>
+
+#include "Node.h"
+#include "NodePool.h"
+
+template<typename T> class BinaryTree;
+
+// The nodes of a flattened tree as a doubly linked list in inorder:
+// left is the previous node, right the next. The list owns the nodes
+// (it took over the tree's pool), so it lives on after the tree and
+// can be turned back into a balanced tree, see BinaryTree(TreeList&&).
+//
+// Keys are read-only: a list flattened from a BST stays sorted.
+template<typename T>
+class TreeList
+{
+public:
+	class iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T* pointer;
+		typedef const T& reference;
+
+		iterator()
+			: node_(nullptr), list_(nullptr)
+		{	}
+
+		reference operator*() const { return node_->data; }
+		pointer operator->() const { return &node_->data; }
+
+		iterator& operator++()
+		{
+			node_ = node_->right;
+			return *this;
+		}
+
+		iterator operator++(int)
+		{
+			iterator it = *this;
+			++*this;
+			return it;
+		}
+
+		// end() steps back to the last node.
+		iterator& operator--()
+		{
+			node_ = node_ ? node_->left : list_->tail_;
+			return *this;
+		}
+
+		iterator operator--(int)
+		{
+			iterator it = *this;
+			--*this;
+			return it;
+		}
+
+		bool operator==(const iterator& rhs) const { return node_ == rhs.node_; }
+		bool operator!=(const iterator& rhs) const { return node_ != rhs.node_; }
+
+	private:
+		friend class TreeList;
+
+		iterator(Node<T>* node, const TreeList* list)
+			: node_(node), list_(list)
+		{	}
+
+		Node<T>* node_;
+		const TreeList* list_;
+	};
+
+	TreeList()
+		: head_(nullptr), tail_(nullptr), size_(0)
+	{	}
+
+	TreeList(const TreeList&) = delete;
+	TreeList& operator=(const TreeList&) = delete;
+
+	TreeList(TreeList&& l)
+		: pool_(std::move(l.pool_)), head_(l.head_), tail_(l.tail_), size_(l.size_)
+	{
+		l.reset();
+	}
+
+	TreeList& operator=(TreeList&& l)
+	{
+		if (this != &l)
+		{
+			pool_ = std::move(l.pool_);
+			head_ = l.head_;
+			tail_ = l.tail_;
+			size_ = l.size_;
+			l.reset();
+		}
+
+		return *this;
+	}
+
+	iterator begin() const { return iterator(head_, this); }
+	iterator end() const { return iterator(nullptr, this); }
+
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+
+	const T& front() const { return head_->data; }
+	const T& back() const { return tail_->data; }
+
+	// Moves all of other in front of pos in O(1). other's nodes move
+	// over with it and other is left empty.
+	void splice(iterator pos, TreeList& other)
+	{
+		if (other.empty() || &other == this)
+			return;
+
+		Node<T>* next = pos.node_;
+		Node<T>* prev = next ? next->left : tail_;
+
+		other.head_->left = prev;
+		other.tail_->right = next;
+
+		if (prev)
+			prev->right = other.head_;
+		else
+			head_ = other.head_;
+
+		if (next)
+			next->left = other.tail_;
+		else
+			tail_ = other.tail_;
+
+		size_ += other.size_;
+		pool_.splice(std::move(other.pool_));
+		other.reset();
+	}
+
+private:
+	template<typename U> friend class BinaryTree;
+
+	void reset()
+	{
+		head_ = nullptr;
+		tail_ = nullptr;
+		size_ = 0;
+	}
+
+	NodePool<T> pool_;
+	Node<T>* head_;
+	Node<T>* tail_;
+	size_t size_;
+};
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef TREERANGE_H
+#define TREERANGE_H
+
+#include <vector>
+#include <iterator>
+
+#include "Node.h"
+
+// The keys of a BST in [lo, hi], in order, as a lazy range. Holds the
+// path of nodes still to visit: subtrees outside the bounds are never
+// entered, so walking k keys costs O(h + k).
+//
+// The range is single pass and must not outlive the tree, which must
+// not change while the range is in use.
+template<typename T>
+class TreeRange
+{
+public:
+	class iterator
+	{
+	public:
+		typedef std::input_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T* pointer;
+		typedef const T& reference;
+
+		explicit iterator(TreeRange* range = nullptr)
+			: range_(range)
+		{	}
+
+		reference operator*() const { return range_->path_.back()->data; }
+		pointer operator->() const { return &range_->path_.back()->data; }
+
+		iterator& operator++()
+		{
+			range_->advance();
+
+			if (range_->done())
+				range_ = nullptr;
+
+			return *this;
+		}
+
+		bool operator==(const iterator& rhs) const { return range_ == rhs.range_; }
+		bool operator!=(const iterator& rhs) const { return range_ != rhs.range_; }
+
+	private:
+		TreeRange* range_;
+	};
+
+	TreeRange(const Node<T>* root, const T& lo, const T& hi)
+		: hi_(hi)
+	{
+		// The nodes >= lo on the way down to lo.
+		while (root)
+		{
+			if (root->data < lo)
+			{
+				root = root->right;
+			}
+			else
+			{
+				path_.push_back(root);
+				root = root->left;
+			}
+		}
+	}
+
+	iterator begin()
+	{
+		return iterator(done() ? nullptr : this);
+	}
+
+	iterator end()
+	{
+		return iterator();
+	}
+
+private:
+	bool done() const
+	{
+		return path_.empty() || hi_ < path_.back()->data;
+	}
+
+	// Next in order: the leftmost node of the right subtree, or else
+	// the nearest ancestor still on the path.
+	void advance()
+	{
+		const Node<T>* node = path_.back()->right;
+
+		path_.pop_back();
+
+		while (node)
+		{
+			path_.push_back(node);
+			node = node->left;
+		}
+	}
+
+	std::vector<const Node<T>*> path_;
+	T hi_;
+};
+
+#endif
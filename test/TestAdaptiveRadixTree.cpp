@@ -0,0 +1,204 @@
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AdaptiveRadixTree.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+class TestAdaptiveRadixTree : public ::testing::Test
+{
+protected:
+
+	// Keys over a small alphabet, so that they share prefixes and
+	// are often prefixes of each other, plus some with a long common
+	// start to go past the bytes a node keeps of its prefix.
+	vector<string> randomKeys(size_t n, unsigned seed)
+	{
+		mt19937 gen(seed);
+		uniform_int_distribution<int> length(0, 6);
+		uniform_int_distribution<int> byte(0, 3);
+		uniform_int_distribution<int> any(0, 255);
+		vector<string> v;
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			string key = i % 4 == 0 ? "a-long-shared-beginning/" : "";
+			int len = length(gen);
+
+			for (int j = 0; j < len; ++j)
+			{
+				key += static_cast<char>(i % 3 == 0 ? any(gen) : 'a' + byte(gen));
+			}
+
+			v.push_back(key);
+		}
+
+		return v;
+	}
+
+	// Byte order, as the tree visits them.
+	static vector<pair<string, int>> sorted(const map<string, int>& m)
+	{
+		return vector<pair<string, int>>(m.begin(), m.end());
+	}
+
+	static vector<pair<string, int>> entries(const AdaptiveRadixTree<int>& t)
+	{
+		vector<pair<string, int>> v;
+
+		t.forEach([&v](const string& key, int value) { v.emplace_back(key, value); });
+
+		return v;
+	}
+};
+
+TEST_F(TestAdaptiveRadixTree, MethodPutFind)
+{
+	AdaptiveRadixTree<int> t;
+
+	EXPECT_TRUE(t.put("abc", 1));
+	EXPECT_TRUE(t.put("ab", 2));
+	EXPECT_TRUE(t.put("", 3));
+	EXPECT_TRUE(t.put("abd", 4));
+	EXPECT_TRUE(t.put(string("a\0b", 3), 5));
+	EXPECT_FALSE(t.put("ab", 6));
+
+	EXPECT_EQ(5, t.size());
+	EXPECT_EQ(6, *t.find("ab"));
+	EXPECT_EQ(3, *t.find(""));
+	EXPECT_EQ(5, *t.find(string("a\0b", 3)));
+	EXPECT_EQ(nullptr, t.find("a"));
+	EXPECT_EQ(nullptr, t.find("abcd"));
+	EXPECT_FALSE(t.contains("b"));
+
+	EXPECT_EQ((vector<pair<string, int>>{ { "", 3 }, { string("a\0b", 3), 5 }, { "ab", 6 }, { "abc", 1 }, { "abd", 4 } }), entries(t));
+
+	EXPECT_TRUE(t.erase("ab"));
+	EXPECT_FALSE(t.erase("ab"));
+	EXPECT_FALSE(t.erase("a"));
+	EXPECT_EQ(1, *t.find("abc"));
+	EXPECT_EQ(4, *t.find("abd"));
+
+	AdaptiveRadixTree<int> moved(std::move(t));
+
+	EXPECT_EQ(4, moved.size());
+	EXPECT_EQ(0, t.size());
+
+	moved.clear();
+
+	EXPECT_TRUE(moved.empty());
+	EXPECT_EQ(0, moved.bytes());
+}
+
+// Against std::map, through every node size and back.
+TEST_F(TestAdaptiveRadixTree, MethodRandom)
+{
+	AdaptiveRadixTree<int> t;
+	map<string, int> m;
+	vector<string> keys = randomKeys(20000, 1);
+	mt19937 gen(2);
+
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		ASSERT_EQ(m.count(keys[i]) == 0, t.put(keys[i], static_cast<int>(i)));
+		m[keys[i]] = static_cast<int>(i);
+	}
+
+	EXPECT_EQ(m.size(), t.size());
+	EXPECT_EQ(sorted(m), entries(t));
+
+	for (const auto& p : m)
+	{
+		ASSERT_NE(nullptr, t.find(p.first));
+		ASSERT_EQ(p.second, *t.find(p.first));
+	}
+
+	for (const auto& key : randomKeys(2000, 3))
+	{
+		ASSERT_EQ(m.count(key) != 0, t.contains(key));
+	}
+
+	// Most of the keys go, in random order, so nodes shrink and merge.
+	shuffle(keys.begin(), keys.end(), gen);
+
+	for (size_t i = 0; i < keys.size() * 9 / 10; ++i)
+	{
+		ASSERT_EQ(m.erase(keys[i]) != 0, t.erase(keys[i]));
+	}
+
+	EXPECT_EQ(m.size(), t.size());
+	EXPECT_EQ(sorted(m), entries(t));
+
+	for (const auto& key : keys)
+	{
+		ASSERT_EQ(m.count(key) != 0, t.contains(key));
+	}
+
+	for (const auto& p : m)
+	{
+		t.erase(p.first);
+	}
+
+	EXPECT_TRUE(t.empty());
+	EXPECT_EQ(0, t.bytes());
+}
+
+TEST_F(TestAdaptiveRadixTree, MethodPrefix)
+{
+	AdaptiveRadixTree<int> t;
+	map<string, int> m;
+	vector<string> keys = randomKeys(5000, 4);
+
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		t.put(keys[i], static_cast<int>(i));
+		m[keys[i]] = static_cast<int>(i);
+	}
+
+	vector<string> queries = randomKeys(500, 5);
+	queries.push_back("");
+	queries.push_back("a-long-shared");
+	queries.push_back("a-long-shared-beginning/");
+	queries.push_back("a-long-sharer");
+
+	for (const auto& q : queries)
+	{
+		vector<pair<string, int>> expected;
+
+		for (auto it = m.lower_bound(q); it != m.end() && it->first.compare(0, q.size(), q) == 0; ++it)
+		{
+			expected.push_back(*it);
+		}
+
+		vector<pair<string, int>> found;
+		t.forEachPrefix(q, [&found](const string& key, int value) { found.emplace_back(key, value); });
+
+		ASSERT_EQ(expected, found) << q;
+
+		const string* longest = nullptr;
+
+		for (size_t len = 0; len <= q.size(); ++len)
+		{
+			auto it = m.find(q.substr(0, len));
+
+			if (it != m.end())
+				longest = &it->first;
+		}
+
+		const AdaptiveRadixTree<int>::Entry* e = t.longestPrefix(q);
+
+		if (longest)
+		{
+			ASSERT_NE(nullptr, e) << q;
+			ASSERT_EQ(*longest, e->key);
+		}
+		else
+		{
+			ASSERT_EQ(nullptr, e) << q;
+		}
+	}
+}
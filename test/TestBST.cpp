@@ -27,13 +27,158 @@ TEST_F(TestBST, MethodLCA)
 	EXPECT_EQ(15, t1.BinaryTree<int>::lca(15, 1)->data);
 }
 
+TEST_F(TestBST, MethodLCABatch)
+{
+	// Includes values not in the tree, where a BST's lca() still
+	// answers with the node the search paths part at.
+	vector<pair<int, int>> queries;
+	vector<int> values = t1.inorder();
+
+	values.push_back(-5);
+	values.push_back(30);
+	values.push_back(1000);
+
+	for (int a : values)
+	{
+		for (int b : values)
+		{
+			queries.push_back(make_pair(a, b));
+		}
+	}
+
+	vector<Node<int>*> batch = t1.lcaBatch(queries);
+
+	ASSERT_EQ(queries.size(), batch.size());
+
+	for (size_t i = 0; i < queries.size(); ++i)
+	{
+		ASSERT_EQ(t1.BinaryTree<int>::lca(queries[i].first, queries[i].second), batch[i]);
+	}
+}
+
 TEST_F(TestBST, MethodToList)
 {
 	BinarySearchTree<int> m1{ 50, 25, 15, 35, 1, 40, 80, 55, 95 };
-	m1.toList();
+	TreeList<int> l1 = m1.toList();
+
+	EXPECT_EQ((vector<int>{ 1, 15, 25, 35, 40, 50, 55, 80, 95 }), vector<int>(l1.begin(), l1.end()));
+}
+
+TEST_F(TestBST, MethodRebalance)
+{
+	// t4 is a chain.
+	vector<int> in = t4.inorder();
+	BinarySearchTree<int> m1(t4.toList());
+
+	EXPECT_EQ(in, m1.inorder());
+	EXPECT_TRUE(m1.isBST());
+	EXPECT_TRUE(m1.isBalanced());
+	EXPECT_TRUE(m1.contains(in.back()));
+}
+
+TEST_F(TestBST, MethodSplit)
+{
+	BinarySearchTree<int> m1 = t1.split(40);
+
+	EXPECT_EQ((vector<int>{ 1, 15, 25, 35 }), t1.inorder());
+	EXPECT_EQ((vector<int>{ 40, 50, 55, 80, 95 }), m1.inorder());
+	EXPECT_TRUE(t1.isBalanced());
+	EXPECT_TRUE(m1.isBalanced());
+
+	// Everything on one side.
+	BinarySearchTree<int> m2 = t4.split(0);
+
+	EXPECT_EQ(0, t4.size());
+	EXPECT_EQ(8, m2.size());
+	EXPECT_EQ(0, m2.split(100).size());
+}
+
+TEST_F(TestBST, MethodSetOperations)
+{
+	auto make = [](vector<int> v) { return BinarySearchTree<int>(v); };
+
+	vector<int> a{ 5, 1, 3, 3, 9 };
+	vector<int> b{ 3, 4, 9, 2 };
+
+	EXPECT_EQ((vector<int>{ 1, 2, 3, 3, 3, 4, 5, 9, 9 }),
+				BinarySearchTree<int>::merge(make(a), make(b)).inorder());
+	EXPECT_EQ((vector<int>{ 1, 2, 3, 3, 4, 5, 9 }),
+				BinarySearchTree<int>::setUnion(make(a), make(b)).inorder());
+	EXPECT_EQ((vector<int>{ 3, 9 }),
+				BinarySearchTree<int>::setIntersection(make(a), make(b)).inorder());
+	EXPECT_EQ((vector<int>{ 1, 3, 5 }),
+				BinarySearchTree<int>::setDifference(make(a), make(b)).inorder());
+
+	BinarySearchTree<int> m1 = BinarySearchTree<int>::setUnion(std::move(t1), std::move(t4));
+
+	EXPECT_EQ(0, t1.size());
+	EXPECT_EQ(16, m1.size());
+	EXPECT_EQ(16, m1.stats().nodes);
+	EXPECT_TRUE(m1.isBST());
+	EXPECT_TRUE(m1.isBalanced());
+}
+
+TEST_F(TestBST, MethodRange)
+{
+	TreeRange<int> r1 = t1.range(20, 55);
+
+	EXPECT_EQ((vector<int>{ 25, 35, 40, 50, 55 }), vector<int>(r1.begin(), r1.end()));
+	EXPECT_EQ(5, t1.countRange(20, 55));
+	EXPECT_EQ(9, t1.countRange(1, 95));
+	EXPECT_EQ(0, t1.countRange(96, 1000));
+	EXPECT_EQ(0, t1.countRange(55, 20));
+	EXPECT_EQ(0, t2.countRange(0, 1));
+}
+
+TEST_F(TestBST, MethodEraseRange)
+{
+	EXPECT_EQ(5, t1.eraseRange(20, 55));
+	EXPECT_EQ((vector<int>{ 1, 15, 80, 95 }), t1.inorder());
+	EXPECT_TRUE(t1.isBST());
+	EXPECT_EQ(4, t1.stats().nodes);
+
+	EXPECT_EQ(0, t1.eraseRange(20, 55));
+	EXPECT_EQ(4, t1.eraseRange(0, 100));
+	EXPECT_EQ(0, t1.size());
+
+	// Duplicates, which go right.
+	BinarySearchTree<int> m1{ 5, 3, 5, 8, 5, 1, 9 };
+
+	EXPECT_EQ(3, m1.eraseRange(5, 5));
+	EXPECT_EQ((vector<int>{ 1, 3, 8, 9 }), m1.inorder());
+
+	// t4 is a chain.
+	EXPECT_EQ(3, t4.eraseRange(2, 4));
+	EXPECT_EQ((vector<int>{ 1, 5, 6, 7, 8 }), t4.inorder());
 }
 
 TEST_F(TestBST, MethodIsBalanced)
 {
 	EXPECT_FALSE(t4.isBalanced());
 }
+
+TEST_F(TestBST, MethodSerialize)
+{
+	stringstream ss;
+	t1.serialize(ss);
+
+	BinarySearchTree<int> m1{ 7, 3 };
+	m1.deserialize(ss);
+
+	EXPECT_TRUE(t1 == m1);
+
+	BinarySearchTree<int> m2(std::move(m1));
+
+	EXPECT_TRUE(t1 == m2);
+	EXPECT_EQ(0, m1.size());
+}
+
+TEST_F(TestBST, MethodContains)
+{
+	EXPECT_TRUE(t1.contains(50));
+	EXPECT_TRUE(t1.contains(1));
+	EXPECT_TRUE(t1.contains(95));
+	EXPECT_FALSE(t1.contains(51));
+	EXPECT_FALSE(t2.contains(50));
+	EXPECT_TRUE(t4.contains(8));
+}
@@ -1,6 +1,7 @@
 #include <algorithm>
+#include <sstream>
 
-#include "BinaryTree.h"
+#include "BinarySearchTree.h"
 #include "gtest/gtest.h"
 
 using namespace std;
@@ -46,7 +47,32 @@ TEST_F(TestBT, MethodMirror)
 TEST_F(TestBT, MethodToList)
 {
 	BinaryTree<int> m1{ 50, 25, 15, 35, 1, 40, 80, 55, 95 };
-	m1.toList();
+	vector<int> in = m1.inorder();
+
+	TreeList<int> l1 = m1.toList();
+
+	EXPECT_EQ(in, vector<int>(l1.begin(), l1.end()));
+	EXPECT_EQ(9, l1.size());
+	EXPECT_EQ(0, m1.size());
+	EXPECT_EQ(in.back(), *--l1.end());
+
+	BinaryTree<int> m2{ 7, 8 };
+	TreeList<int> l2 = m2.toList();
+
+	// m2's nodes go into l1 after the first element.
+	l1.splice(++l1.begin(), l2);
+	in.insert(in.begin() + 1, { 8, 7 });
+
+	EXPECT_EQ(in, vector<int>(l1.begin(), l1.end()));
+	EXPECT_TRUE(l2.empty());
+
+	BinaryTree<int> m3(std::move(l1));
+
+	EXPECT_EQ(in, m3.inorder());
+	EXPECT_EQ(11, m3.stats().nodes);
+	EXPECT_EQ(4, m3.height());
+	EXPECT_TRUE(m3.isBalanced());
+	EXPECT_TRUE(l1.empty());
 }
 
 TEST_F(TestBT, MethodLeafCount)
@@ -72,6 +98,51 @@ TEST_F(TestBT, MethodSpiralOrder)
 	t2.spiralOrder();
 }
 
+TEST_F(TestBT, MethodLevelOrder)
+{
+	BinaryTree<int> tree { 50, 25, 15, 35, 1, 40 };
+	vector<pair<size_t, int>> v;
+
+	for (auto p : tree.levelOrder())
+	{
+		v.push_back(make_pair(p.first, p.second->data));
+	}
+
+	EXPECT_EQ((vector<pair<size_t, int>>{ {0, 50}, {1, 25}, {1, 15}, {2, 35}, {2, 1}, {2, 40} }), v);
+
+	size_t count = 0;
+
+	for (auto p : tree.levelOrder(2))
+	{
+		EXPECT_GT(2, p.first);
+		++count;
+	}
+
+	EXPECT_EQ(3, count);
+	EXPECT_TRUE(BinaryTree<int>().levelOrder().begin() == BinaryTree<int>().levelOrder().end());
+}
+
+TEST_F(TestBT, MethodWrite)
+{
+	BinaryTree<int> tree { 50, 25, 15, 35, 1, 40 };
+	ostringstream out;
+
+	tree.writeLevelOrder(out);
+	EXPECT_EQ("50\t\n25\t15\t\n35\t1\t40\t\n", out.str());
+
+	out.str("");
+	tree.writeLevelOrder(out, 2);
+	EXPECT_EQ("50\t\n25\t15\t\n", out.str());
+
+	out.str("");
+	tree.writeSpiral(out);
+	EXPECT_EQ("50 \n25 15 \n40 1 35 \n", out.str());
+
+	out.str("");
+	tree.writePretty(out, 1);
+	EXPECT_EQ("-----50\n", out.str());
+}
+
 TEST_F(TestBT, MethodIsSumProperty)
 {
 	EXPECT_FALSE(t1.isSumProperty());
@@ -88,6 +159,35 @@ TEST_F(TestBT, MethodToSumProperty)
 	EXPECT_TRUE(tree.isSumProperty());
 }
 
+TEST_F(TestBT, MethodToSumPropertyPaths)
+{
+	// Same keys as the old increment-walk version gave: a node above
+	// the sum of its children pushes the difference down its left path.
+	BinaryTree<int> tree(BinarySearchTree<int>{ 50, 30, 70, 20, 40, 60, 80, 35, 45, 65, 10, 90, 85, 5, 75, 42 });
+	tree.toSumProperty();
+
+	EXPECT_EQ((vector<int>{ 330, 100, 20, 20, 20, 80, 35, 45, 45, 230, 65, 65, 165, 75, 90, 90 }), tree.preorder());
+	EXPECT_TRUE(tree.isSumProperty());
+
+	// A left chain with keys falling downwards: every node pushes down
+	// the rest of the chain, which was O(n^2).
+	vector<int> in(20000);
+	vector<int> pre(in.size());
+
+	for (size_t i = 0; i < in.size(); ++i)
+	{
+		in[i] = static_cast<int>(i + 1);
+		pre[i] = static_cast<int>(in.size() - i);
+	}
+
+	BinaryTree<int> chain = BinaryTree<int>::fromInorderPreorder(in.begin(), in.end(), pre.begin(), pre.end());
+	chain.toSumProperty();
+
+	vector<int> keys = chain.inorderWithoutRecursion();
+
+	EXPECT_EQ(vector<int>(keys.size(), 20000), keys);
+}
+
 TEST_F(TestBT, MethodIsBalanced)
 {
 	BinaryTree<int> tree { 50, 25, 15, 35, 1, 40, 80, 55, 95 };
@@ -129,10 +229,131 @@ TEST_F(TestBT, MethodCreateTree)
 	EXPECT_EQ(v1, v2);
 }
 
+TEST_F(TestBT, MethodFromTraversals)
+{
+	vector<int> in = t1.inorder();
+	vector<int> pre = t1.preorder();
+	vector<int> post = t1.postorder();
+
+	BinaryTree<int> m1 = BinaryTree<int>::fromInorderPreorder(in.begin(), in.end(), pre.begin(), pre.end());
+	BinaryTree<int> m2 = BinaryTree<int>::fromInorderPostorder(in.begin(), in.end(), post.begin(), post.end());
+
+	EXPECT_EQ(in, m1.inorder());
+	EXPECT_EQ(pre, m1.preorder());
+	EXPECT_EQ(in, m2.inorder());
+	EXPECT_EQ(post, m2.postorder());
+
+	// t4 is full: every node has 0 or 2 children.
+	pre = t4.preorder();
+	post = t4.postorder();
+
+	BinaryTree<int> m3 = BinaryTree<int>::fromPreorderPostorder(pre.begin(), pre.end(), post.begin(), post.end());
+
+	EXPECT_EQ(t4.inorder(), m3.inorder());
+	EXPECT_EQ(pre, m3.preorder());
+
+	EXPECT_EQ(0, BinaryTree<int>::fromInorderPreorder(in.end(), in.end(), pre.end(), pre.end()).size());
+}
+
+TEST_F(TestBT, MethodFromTraversalsDeep)
+{
+	// A chain far deeper than the call stack would take.
+	vector<int> in(1000000);
+	vector<int> pre(in.size());
+
+	for (size_t i = 0; i < in.size(); ++i)
+	{
+		in[i] = static_cast<int>(i);
+		pre[i] = static_cast<int>(in.size() - 1 - i);
+	}
+
+	BinaryTree<int> m1 = BinaryTree<int>::fromInorderPreorder(in.begin(), in.end(), pre.begin(), pre.end());
+
+	// Only iterative walks: the recursive ones would overflow too.
+	EXPECT_EQ(in, m1.inorderWithoutRecursion());
+}
+
+TEST_F(TestBT, MethodForEachPath)
+{
+	vector<vector<int>> paths;
+	auto collect = [&paths](const int* path, size_t length)
+	{
+		paths.push_back(vector<int>(path, path + length));
+	};
+
+	t1.forEachPath(collect);
+
+	vector<vector<int>> all{ { 50, 25, 35, 55 }, { 50, 25, 35, 95 }, { 50, 25, 1 },
+								{ 50, 15, 40 }, { 50, 15, 80 } };
+	EXPECT_EQ(all, paths);
+
+	// Only under 25.
+	paths.clear();
+	t1.forEachPath([](const int* path, size_t length) { return length < 2 || path[1] == 25; }, collect);
+
+	EXPECT_EQ(vector<vector<int>>(all.begin(), all.begin() + 3), paths);
+
+	paths.clear();
+	t1.forEachPathWithSum(105, collect);
+	t1.forEachPathWithSum(76, collect, true);
+
+	EXPECT_EQ((vector<vector<int>>{ { 50, 15, 40 }, { 50, 25, 1 } }), paths);
+
+	paths.clear();
+	t2.forEachPath(collect);
+
+	EXPECT_TRUE(paths.empty());
+}
+
 TEST_F(TestBT, MethodIsSubTree)
 {
 	BinaryTree<int> m1{ 25, 35, 1, 55, 95};
 
 	EXPECT_FALSE(t1.isSubTree(t3));
 	EXPECT_TRUE(t1.isSubTree(m1));
-}
\ No newline at end of file
+}
+
+TEST_F(TestBT, MethodLCABatch)
+{
+	vector<int> values = t1.preorder();
+	vector<pair<int, int>> queries;
+
+	for (const auto& a : values)
+	{
+		for (const auto& b : values)
+		{
+			queries.push_back(make_pair(a, b));
+		}
+	}
+
+	// Values missing from the tree.
+	queries.push_back(make_pair(15, 1000));
+	queries.push_back(make_pair(1000, 2000));
+
+	vector<Node<int>*> result = t1.lcaBatch(queries);
+
+	ASSERT_EQ(queries.size(), result.size());
+
+	for (size_t i = 0; i < queries.size(); ++i)
+	{
+		EXPECT_EQ(t1.lca(queries[i].first, queries[i].second), result[i]);
+	}
+
+	EXPECT_TRUE(t2.lcaBatch(queries)[0] == nullptr);
+}
+
+TEST_F(TestBT, MethodMove)
+{
+	BinaryTree<int> m1{ 50, 25, 15, 35, 1, 40, 80, 55, 95 };
+	vector<int> v1 = m1.inorder();
+
+	BinaryTree<int> m2(std::move(m1));
+
+	EXPECT_EQ(v1, m2.inorder());
+	EXPECT_EQ(0, m1.size());
+
+	m1 = std::move(m2);
+
+	EXPECT_EQ(v1, m1.inorder());
+	EXPECT_EQ(9, m1.size());
+}
@@ -0,0 +1,152 @@
+#include <thread>
+#include <vector>
+
+#include "Cache.h"
+#include "ShardedCache.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+class TestCache : public ::testing::Test
+{
+protected:
+
+	Cache<int, int> c1{ 3 };
+};
+
+TEST_F(TestCache, MethodLru)
+{
+	c1.put(1, 10);
+	c1.put(2, 20);
+	c1.put(3, 30);
+
+	// 1 becomes the most recent, so 2 goes.
+	EXPECT_EQ(10, *c1.get(1));
+
+	c1.put(4, 40);
+
+	EXPECT_FALSE(c1.contains(2));
+	EXPECT_TRUE(c1.contains(1));
+	EXPECT_EQ(nullptr, c1.get(2));
+	EXPECT_EQ(3, c1.size());
+
+	CacheStats s = c1.stats();
+
+	EXPECT_EQ(1, s.hits);
+	EXPECT_EQ(1, s.misses);
+	EXPECT_EQ(4, s.inserts);
+	EXPECT_EQ(1, s.evictions);
+}
+
+TEST_F(TestCache, MethodErase)
+{
+	c1.put(1, 10);
+	c1.put(2, 20);
+
+	EXPECT_TRUE(c1.erase(1));
+	EXPECT_FALSE(c1.erase(1));
+
+	c1.put(3, 30);
+	c1.put(4, 40);
+
+	// The erased slot was reused; nothing had to be evicted.
+	EXPECT_EQ(0, c1.stats().evictions);
+	EXPECT_EQ(20, *c1.get(2));
+	EXPECT_EQ(40, *c1.get(4));
+}
+
+TEST_F(TestCache, MethodClock)
+{
+	Cache<int, int, ClockPolicy> c(3);
+
+	c.put(1, 10);
+	c.put(2, 20);
+	c.put(3, 30);
+	c.get(1);
+
+	// 1 gets a second chance, 2 does not.
+	c.put(4, 40);
+
+	EXPECT_TRUE(c.contains(1));
+	EXPECT_FALSE(c.contains(2));
+	EXPECT_TRUE(c.contains(3));
+	EXPECT_TRUE(c.contains(4));
+}
+
+TEST_F(TestCache, MethodS3FifoScan)
+{
+	Cache<int, int, S3FifoPolicy> c(100);
+
+	// A hot set that is hit a few times.
+	for (int round = 0; round < 3; ++round)
+	{
+		for (int k = 0; k < 50; ++k)
+		{
+			if (!c.get(k))
+				c.put(k, k);
+		}
+	}
+
+	// A scan of keys that are used once.
+	for (int k = 1000; k < 2000; ++k)
+	{
+		c.put(k, k);
+	}
+
+	for (int k = 0; k < 50; ++k)
+	{
+		EXPECT_TRUE(c.contains(k));
+	}
+}
+
+TEST_F(TestCache, MethodSharded)
+{
+	ShardedCache<int, int> c(1000, 8);
+	vector<thread> threads;
+
+	for (int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&c, t]()
+		{
+			for (int k = 0; k < 10000; ++k)
+			{
+				int key = (k * 4 + t) % 500;
+				int value;
+
+				if (c.get(key, value))
+					EXPECT_EQ(key, value);
+				else
+					c.put(key, key);
+			}
+		});
+	}
+
+	for (auto& t : threads)
+	{
+		t.join();
+	}
+
+	CacheStats s = c.stats();
+
+	EXPECT_EQ(40000, s.hits + s.misses);
+	EXPECT_EQ(500, c.size());
+	EXPECT_EQ(0, s.evictions);
+}
+
+TEST_F(TestCache, MethodShardedCapacity)
+{
+	// Never more entries than asked for, however it splits.
+	for (size_t capacity : { 1, 3, 10, 17, 1000 })
+	{
+		ShardedCache<int, int> c(capacity, 16);
+
+		EXPECT_EQ(capacity, c.capacity());
+
+		for (int k = 0; k < 5000; ++k)
+		{
+			c.put(k, k);
+		}
+
+		EXPECT_EQ(capacity, c.size()) << capacity;
+	}
+}
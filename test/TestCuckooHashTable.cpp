@@ -0,0 +1,90 @@
+#include "CuckooHashTable.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+class TestCuckooHashTable : public ::testing::Test
+{
+protected:
+
+	CuckooHashTable<int, float> h1;
+};
+
+TEST_F(TestCuckooHashTable, MethodPutGet)
+{
+	h1.put(1, 1.1f);
+	h1.put(2, 2.2f);
+
+	EXPECT_EQ(1.1f, h1.get(1));
+	EXPECT_EQ(2.2f, h1.get(2));
+
+	h1.put(2, 3.3f);
+
+	EXPECT_EQ(3.3f, h1.get(2));
+	EXPECT_EQ(2, h1.size());
+	EXPECT_FALSE(h1.contains(3));
+	EXPECT_EQ(0.0f, h1.get(3));
+}
+
+TEST_F(TestCuckooHashTable, MethodGrow)
+{
+	// Strided keys collide in HashTable; here they only force resizes.
+	for (int i = 0; i < 10000; ++i)
+	{
+		h1.put(i * 64, i + 0.5f);
+	}
+
+	EXPECT_EQ(10000, h1.size());
+	EXPECT_LT(0.25, h1.loadFactor());
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		ASSERT_EQ(i + 0.5f, h1.get(i * 64));
+	}
+
+	size_t count = 0;
+	h1.forEach([&count](int, float){ ++count; });
+
+	EXPECT_EQ(10000, count);
+}
+
+TEST_F(TestCuckooHashTable, MethodHighLoad)
+{
+	// 4-way buckets fill to well over 90% before the first resize.
+	CuckooHashTable<int, int> h(4096);
+
+	size_t buckets = h.bucketCount();
+	int i = 0;
+
+	while (h.bucketCount() == buckets)
+	{
+		h.put(i, i);
+		++i;
+	}
+
+	EXPECT_LT(0.9 * 4096, static_cast<double>(i - 1));
+
+	for (int k = 0; k < i; ++k)
+	{
+		ASSERT_EQ(k, h.get(k));
+	}
+}
+
+TEST_F(TestCuckooHashTable, MethodErase)
+{
+	for (int i = 0; i < 100; ++i)
+	{
+		h1.put(i, i + 0.5f);
+	}
+
+	EXPECT_TRUE(h1.erase(10));
+	EXPECT_FALSE(h1.erase(10));
+	EXPECT_FALSE(h1.contains(10));
+	EXPECT_EQ(99, h1.size());
+	EXPECT_EQ(11.5f, h1.get(11));
+
+	h1.put(10, 1.0f);
+
+	EXPECT_EQ(1.0f, h1.get(10));
+	EXPECT_EQ(100, h1.size());
+}
@@ -0,0 +1,254 @@
+#include <vector>
+#include <sstream>
+#include <random>
+#include <algorithm>
+
+#include "BloomFilter.h"
+#include "CuckooFilter.h"
+#include "XorFilter.h"
+#include "PreFilter.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+class TestFilters : public ::testing::Test
+{
+protected:
+	TestFilters()
+	{
+		for (int i = 0; i < 10000; ++i)
+		{
+			keys.push_back(i * 7);
+		}
+	}
+
+	// Fraction of 10000 absent keys the filter lets through.
+	template<typename Filter>
+	double falsePositives(const Filter& f)
+	{
+		size_t count = 0;
+
+		for (int i = 0; i < 10000; ++i)
+		{
+			count += f.contains(i * 7 + 3);
+		}
+
+		return count / 10000.0;
+	}
+
+	vector<int> keys;
+};
+
+TEST_F(TestFilters, MethodBloom)
+{
+	BloomFilter<int> f(keys.begin(), keys.end());
+
+	for (int k : keys)
+	{
+		ASSERT_TRUE(f.contains(k));
+	}
+
+	EXPECT_GT(0.03, falsePositives(f));
+}
+
+TEST_F(TestFilters, MethodBloomKernels)
+{
+	// The dispatched kernels (AVX2 where the CPU has it) set and test
+	// the same bits as the scalar ones.
+	mt19937 gen(5);
+
+	for (int round = 0; round < 1000; ++round)
+	{
+		alignas(32) uint32_t scalar[8] = {};
+		alignas(32) uint32_t simd[8] = {};
+
+		for (int i = 0; i < 4; ++i)
+		{
+			uint32_t h = gen();
+
+			kernels::bloomInsertScalar(scalar, h);
+			kernels::bloomInsert(simd, h);
+		}
+
+		ASSERT_TRUE(equal(scalar, scalar + 8, simd));
+
+		for (int i = 0; i < 8; ++i)
+		{
+			uint32_t h = gen();
+
+			ASSERT_EQ(kernels::bloomContainsScalar(scalar, h), kernels::bloomContains(simd, h));
+		}
+	}
+}
+
+TEST_F(TestFilters, MethodCuckoo)
+{
+	CuckooFilter<int> f(keys.size());
+
+	for (int k : keys)
+	{
+		ASSERT_TRUE(f.insert(k));
+	}
+
+	for (int k : keys)
+	{
+		ASSERT_TRUE(f.contains(k));
+	}
+
+	EXPECT_GT(0.001, falsePositives(f));
+
+	EXPECT_TRUE(f.erase(7));
+	EXPECT_FALSE(f.contains(7));
+	EXPECT_TRUE(f.contains(14));
+	EXPECT_EQ(keys.size() - 1, f.size());
+}
+
+TEST_F(TestFilters, MethodCuckooFull)
+{
+	CuckooFilter<int> f(16);
+	size_t inserted = 0;
+
+	while (f.insert(static_cast<int>(inserted)))
+	{
+		++inserted;
+	}
+
+	// Even the refused key is kept; only the next one is dropped.
+	for (size_t k = 0; k <= inserted; ++k)
+	{
+		ASSERT_TRUE(f.contains(static_cast<int>(k)));
+	}
+
+	EXPECT_FALSE(f.insert(-1));
+}
+
+TEST_F(TestFilters, MethodXor)
+{
+	keys.push_back(0);
+
+	XorFilter<int> f(keys.begin(), keys.end());
+
+	for (int k : keys)
+	{
+		ASSERT_TRUE(f.contains(k));
+	}
+
+	EXPECT_GT(0.01, falsePositives(f));
+	EXPECT_GT(11 * keys.size() / 8, f.bytes());
+}
+
+TEST_F(TestFilters, MethodFilteredHashTable)
+{
+	FilteredHashTable<int, int, BloomFilter<int>> h(1000, BloomFilter<int>(keys.size()));
+
+	for (int k : keys)
+	{
+		h.put(k, k + 1);
+	}
+
+	for (int k : keys)
+	{
+		ASSERT_EQ(k + 1, *h.find(k));
+	}
+
+	EXPECT_FALSE(h.contains(3));
+	EXPECT_EQ(nullptr, h.find(3));
+	EXPECT_EQ(keys.size(), h.size());
+}
+
+TEST_F(TestFilters, MethodFilteredHashTableBypass)
+{
+	// A tiny cuckoo filter fills up; lookups must stay exact.
+	FilteredHashTable<int, int, CuckooFilter<int>> h(100, CuckooFilter<int>(8));
+
+	for (int k : keys)
+	{
+		h.put(k, k);
+	}
+
+	for (int k : keys)
+	{
+		ASSERT_TRUE(h.contains(k));
+	}
+
+	EXPECT_FALSE(h.contains(3));
+}
+
+TEST_F(TestFilters, MethodFilteredHashTableChurn)
+{
+	// Erase and put back the same keys many times: the cuckoo filter
+	// must not collect a copy per round and fill up.
+	FilteredHashTable<int, int, CuckooFilter<int>> h(1000, CuckooFilter<int>(keys.size()));
+
+	for (int round = 0; round < 50; ++round)
+	{
+		for (int k : keys)
+		{
+			h.put(k, round);
+		}
+
+		ASSERT_EQ(keys.size(), h.filter().size()) << round;
+
+		for (size_t i = 0; i < keys.size(); i += 2)
+		{
+			ASSERT_TRUE(h.erase(keys[i]));
+		}
+
+		ASSERT_FALSE(h.erase(keys[0]));
+	}
+
+	EXPECT_EQ(keys.size() / 2, h.filter().size());
+	EXPECT_FALSE(h.contains(keys[0]));
+	EXPECT_TRUE(h.contains(keys[1]));
+	EXPECT_EQ(49, h.get(keys[1]));
+}
+
+TEST_F(TestFilters, MethodFilteredHashTableImport)
+{
+	FilteredHashTable<int, int, BloomFilter<int>> h(16, BloomFilter<int>(keys.size()));
+	vector<int> values(keys.begin(), keys.end());
+
+	h.put(-1, 0);
+	h.importFrom(keys.data(), values.data(), keys.size());
+
+	for (int k : keys)
+	{
+		ASSERT_TRUE(h.contains(k));
+	}
+
+	EXPECT_TRUE(h.contains(-1));
+	EXPECT_FALSE(h.contains(3));
+
+	// Still exact after the table grows.
+	h.rehash(4 * keys.size());
+
+	for (int k : keys)
+	{
+		ASSERT_TRUE(h.contains(k));
+	}
+}
+
+TEST_F(TestFilters, MethodFilteredBSTEraseRange)
+{
+	FilteredBinarySearchTree<int, XorFilter<int>> t{ 50, 30, 70, 20, 40, 60, 80 };
+
+	EXPECT_EQ(2u, t.eraseRange(35, 55));
+	EXPECT_FALSE(t.contains(40));
+	EXPECT_FALSE(t.contains(50));
+	EXPECT_TRUE(t.contains(60));
+	EXPECT_EQ(5u, t.size());
+}
+
+TEST_F(TestFilters, MethodFilteredBST)
+{
+	FilteredBinarySearchTree<int, XorFilter<int>> t{ 50, 30, 70, 20, 40, 60, 80 };
+
+	EXPECT_TRUE(t.contains(40));
+	EXPECT_FALSE(t.contains(45));
+
+	stringstream ss("10 5 15");
+	t.deserialize(ss);
+
+	EXPECT_TRUE(t.contains(15));
+	EXPECT_FALSE(t.contains(40));
+}
@@ -0,0 +1,85 @@
+#include "FixedHashTable.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+class TestFixedHashTable : public ::testing::Test
+{
+protected:
+
+	FixedHashTable<int, float, 16> h1;
+};
+
+// Built entirely at compile time.
+constexpr FixedHashTable<int, int, 8> makeTable()
+{
+	FixedHashTable<int, int, 8> t;
+
+	t.put(1, 10);
+	t.put(9, 90);
+	t.put(17, 170);
+	t.put(9, 99);
+
+	return t;
+}
+
+static_assert(makeTable().get(9) == 99, "constexpr put/get");
+static_assert(makeTable().size() == 3, "constexpr size");
+static_assert(!makeTable().contains(2), "constexpr contains");
+
+TEST_F(TestFixedHashTable, MethodPutGet)
+{
+	h1.put(1, 1.1f);
+	h1.put(2, 2.2f);
+
+	EXPECT_EQ(1.1f, h1.get(1));
+	EXPECT_EQ(2.2f, h1.get(2));
+
+	h1.put(2, 3.3f);
+
+	EXPECT_EQ(3.3f, h1.get(2));
+	EXPECT_EQ(2, h1.size());
+	EXPECT_FALSE(h1.contains(3));
+	EXPECT_EQ(0.0f, h1.get(3));
+}
+
+TEST_F(TestFixedHashTable, MethodFull)
+{
+	for (int i = 0; i < 16; ++i)
+	{
+		EXPECT_TRUE(h1.put(i * 16, i + 0.5f));
+	}
+
+	EXPECT_FALSE(h1.put(1000, 1.0f));
+	EXPECT_TRUE(h1.put(16, 7.0f));
+
+	for (int i = 0; i < 16; ++i)
+	{
+		EXPECT_TRUE(h1.contains(i * 16));
+	}
+
+	EXPECT_EQ(7.0f, h1.get(16));
+
+	h1.clear();
+
+	EXPECT_EQ(0, h1.size());
+	EXPECT_FALSE(h1.contains(16));
+}
+
+TEST_F(TestFixedHashTable, MethodQuadraticProbe)
+{
+	// 4 KB of keys selects quadratic probing.
+	FixedHashTable<int, int, 1024> h;
+
+	static_assert(std::is_same<DefaultProbe<int, 1024>::type, QuadraticProbe>::value, "");
+
+	for (int i = 0; i < 1024; ++i)
+	{
+		EXPECT_TRUE(h.put(i * 7, i));
+	}
+
+	for (int i = 0; i < 1024; ++i)
+	{
+		EXPECT_EQ(i, h.get(i * 7));
+	}
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+
+#include "FlatBinaryTree.h"
+#include "BinarySearchTree.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+class TestFlatBinaryTree : public ::testing::Test
+{
+protected:
+
+	FlatBinaryTree<int> t1{ 50, 25, 15, 35, 1, 40, 80, 55, 95 };
+	FlatBinaryTree<int> t2;
+	FlatBinaryTree<int> t3 { 200 };
+	FlatBinaryTree<int> t5 { 5, 3, 7, 1, 4, 6, 8 };
+	FlatBinaryTree<int> t6 { 12, 3, 9, 1, 2, 4, 5 };
+
+	BinaryTree<int> b1{ 50, 25, 15, 35, 1, 40, 80, 55, 95 };
+	BinarySearchTree<int> s1{ 50, 25, 15, 35, 1, 40, 80, 55, 95 };
+};
+
+TEST_F(TestFlatBinaryTree, MethodTraversals)
+{
+	EXPECT_EQ(b1.inorder(), t1.inorder());
+	EXPECT_EQ(b1.preorder(), t1.preorder());
+	EXPECT_EQ(b1.postorder(), t1.postorder());
+
+	FlatBinaryTree<int> f1(s1);
+
+	EXPECT_EQ(s1.inorder(), f1.inorder());
+	EXPECT_EQ(s1.preorder(), f1.preorder());
+	EXPECT_EQ(s1.postorder(), f1.postorder());
+
+	EXPECT_TRUE(t2.inorder().empty());
+}
+
+TEST_F(TestFlatBinaryTree, MethodMetrics)
+{
+	FlatBinaryTree<int> f1(s1);
+
+	EXPECT_EQ(9, t1.size());
+	EXPECT_EQ(b1.height(), t1.height());
+	EXPECT_EQ(s1.height(), f1.height());
+	EXPECT_EQ(0, t2.height());
+
+	EXPECT_EQ(5, t1.leafCount());
+	EXPECT_EQ(0, t2.leafCount());
+	EXPECT_EQ(1, t3.leafCount());
+	EXPECT_EQ(s1.leafCount(), f1.leafCount());
+}
+
+TEST_F(TestFlatBinaryTree, MethodIsBST)
+{
+	EXPECT_FALSE(t1.isBST());
+	EXPECT_TRUE(t2.isBST());
+	EXPECT_TRUE(t3.isBST());
+	EXPECT_TRUE(t5.isBST());
+	EXPECT_TRUE(FlatBinaryTree<int>(s1).isBST());
+
+	EXPECT_FALSE(t1.isSumProperty());
+	EXPECT_TRUE(t6.isSumProperty());
+}
+
+TEST_F(TestFlatBinaryTree, MethodMirror)
+{
+	vector<int> v1 = t1.inorder();
+
+	t1.mirror();
+
+	vector<int> v2 = t1.inorder();
+	reverse(v2.begin(), v2.end());
+
+	EXPECT_EQ(v1, v2);
+
+	// Level order is the storage order only until the mirror.
+	EXPECT_EQ((vector<int>{ 50, 15, 25, 80, 40, 1, 35, 95, 55 }), t1.levelorder());
+
+	t1.mirror();
+
+	EXPECT_EQ((vector<int>{ 50, 25, 15, 35, 1, 40, 80, 55, 95 }), t1.levelorder());
+}
+
+// The dispatched kernels must agree with the scalar ones around every
+// vector boundary.
+TEST_F(TestFlatBinaryTree, MethodKernels)
+{
+	vector<int> v(37);
+
+	for (size_t i = 0; i < v.size(); ++i)
+	{
+		v[i] = static_cast<int>(i * 3) - 50;
+	}
+
+	EXPECT_TRUE(kernels::isStrictlyIncreasing(v.data(), v.size()));
+
+	for (size_t i = 1; i < v.size(); ++i)
+	{
+		vector<int> w = v;
+		w[i] = w[i - 1];
+
+		ASSERT_FALSE(kernels::isStrictlyIncreasing(w.data(), w.size()));
+	}
+
+	// A complete tree whose nodes are the sums of their children.
+	size_t n = 45;
+	vector<int> keys(n, 1);
+	vector<uint32_t> left(n, kernels::nil);
+	vector<uint32_t> right(n, kernels::nil);
+
+	for (size_t i = n; i-- > 0; )
+	{
+		if (2 * i + 1 < n)
+			left[i] = static_cast<uint32_t>(2 * i + 1);
+
+		if (2 * i + 2 < n)
+			right[i] = static_cast<uint32_t>(2 * i + 2);
+
+		if (left[i] != kernels::nil)
+			keys[i] = keys[left[i]] + (right[i] != kernels::nil ? keys[right[i]] : 0);
+	}
+
+	EXPECT_EQ(kernels::leafCountScalar(left.data(), right.data(), n),
+			kernels::leafCount(left.data(), right.data(), n));
+	EXPECT_EQ(23, kernels::leafCount(left.data(), right.data(), n));
+	EXPECT_TRUE(kernels::isSumProperty(keys.data(), left.data(), right.data(), n));
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (left[i] == kernels::nil)
+			continue;
+
+		++keys[i];
+		ASSERT_FALSE(kernels::isSumProperty(keys.data(), left.data(), right.data(), n));
+		--keys[i];
+	}
+}
+
+TEST_F(TestFlatBinaryTree, MethodLCA)
+{
+	EXPECT_EQ(50, t1.data(t1.lca(15, 1)));
+	EXPECT_EQ(35, t1.data(t1.lca(55, 95)));
+	EXPECT_EQ(15, t1.data(t1.lca(15, 1000)));
+	EXPECT_EQ(FlatBinaryTree<int>::nil, t1.lca(1000, 2000));
+
+	FlatBinaryTree<int> f1(s1);
+	vector<int> v = s1.inorder();
+
+	for (const auto& a : v)
+	{
+		for (const auto& b : v)
+		{
+			EXPECT_EQ(s1.BinaryTree<int>::lca(a, b)->data, f1.data(f1.lca(a, b)));
+		}
+	}
+}
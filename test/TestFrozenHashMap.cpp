@@ -0,0 +1,128 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "FrozenHashMap.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+class TestFrozenHashMap : public ::testing::Test
+{
+protected:
+
+	TestFrozenHashMap()
+	{
+		for (int i = 0; i < 100000; ++i)
+		{
+			v.push_back(make_pair(i * 7, i * 0.5));
+		}
+	}
+
+	vector<pair<int, double>> v;
+};
+
+TEST_F(TestFrozenHashMap, MethodBuildFind)
+{
+	FrozenHashMap<int, double> f = FrozenHashMap<int, double>::build(v.begin(), v.end());
+
+	EXPECT_EQ(v.size(), f.size());
+
+	for (const auto& ele : v)
+	{
+		EXPECT_EQ(ele.second, f.get(ele.first));
+	}
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		EXPECT_FALSE(f.contains(i * 7 + 1));
+	}
+
+	EXPECT_GT(3.5, f.bitsPerKey());
+}
+
+TEST_F(TestFrozenHashMap, MethodNoFingerprints)
+{
+	FrozenHashMap<int, double> f = FrozenHashMap<int, double>::build(v.begin(), v.end(), false);
+
+	for (const auto& ele : v)
+	{
+		EXPECT_EQ(ele.second, f.get(ele.first));
+	}
+
+	EXPECT_FALSE(f.contains(1));
+}
+
+TEST_F(TestFrozenHashMap, MethodFromHashTable)
+{
+	HashTable<int, float> h(10);
+
+	h.put(1, 1.1f);
+	h.put(2, 2.2f);
+	h.put(2, 3.3f);
+	h.put(42, 4.2f);
+
+	FrozenHashMap<int, float> f = FrozenHashMap<int, float>::build(h);
+
+	EXPECT_EQ(3, f.size());
+	EXPECT_EQ(1.1f, f.get(1));
+	EXPECT_EQ(3.3f, f.get(2));
+	EXPECT_EQ(4.2f, f.get(42));
+	EXPECT_FALSE(f.contains(3));
+
+	FrozenHashMap<int, float> empty = FrozenHashMap<int, float>::build(HashTable<int, float>(4));
+
+	EXPECT_EQ(0, empty.size());
+	EXPECT_FALSE(empty.contains(1));
+}
+
+TEST_F(TestFrozenHashMap, MethodDuplicates)
+{
+	vector<pair<int, int>> d{ { 1, 10 }, { 2, 20 }, { 1, 11 } };
+
+	FrozenHashMap<int, int> f = FrozenHashMap<int, int>::build(d.begin(), d.end());
+
+	EXPECT_EQ(2, f.size());
+	EXPECT_EQ(11, f.get(1));
+}
+
+TEST_F(TestFrozenHashMap, MethodView)
+{
+	FrozenHashMap<int, double> f = FrozenHashMap<int, double>::build(v.begin(), v.end());
+
+	// Stands in for a file that is mmap'ed later: 8-byte aligned copy.
+	vector<uint64_t> blob((f.bytes() + 7) / 8);
+	memcpy(blob.data(), f.data(), f.bytes());
+
+	FrozenHashMap<int, double> g = FrozenHashMap<int, double>::view(blob.data(), f.bytes());
+
+	EXPECT_EQ(f.size(), g.size());
+
+	for (const auto& ele : v)
+	{
+		EXPECT_EQ(ele.second, g.get(ele.first));
+	}
+
+	EXPECT_THROW((FrozenHashMap<int, int>::view(blob.data(), f.bytes())), std::runtime_error);
+
+	// A header that promises more than the blob holds.
+	EXPECT_THROW((FrozenHashMap<int, double>::view(blob.data(), f.bytes() - 8)), std::runtime_error);
+	EXPECT_THROW((FrozenHashMap<int, double>::view(blob.data(), 64)), std::runtime_error);
+}
+
+TEST_F(TestFrozenHashMap, MethodMove)
+{
+	FrozenHashMap<int, double> f = FrozenHashMap<int, double>::build(v.begin(), v.end());
+	FrozenHashMap<int, double> g(std::move(f));
+
+	EXPECT_EQ(v.size(), g.size());
+	EXPECT_EQ(0, f.size());
+	EXPECT_EQ(nullptr, f.data());
+	EXPECT_FALSE(f.contains(v[0].first));
+
+	f = std::move(g);
+
+	EXPECT_EQ(v.size(), f.size());
+	EXPECT_EQ(0, g.size());
+	EXPECT_EQ(v[0].second, f.get(v[0].first));
+}
@@ -25,3 +25,135 @@ TEST_F(TestHashTable, MethodPutGet)
 
 	EXPECT_EQ(3.3f, h1.get(2));
 }
+
+TEST_F(TestHashTable, MethodPutGetWrap)
+{
+	// Keys beyond the table size share buckets with smaller ones.
+	for (int i = 0; i < 100; ++i)
+	{
+		h1.put(i, i + 0.5f);
+	}
+
+	for (int i = 0; i < 100; ++i)
+	{
+		EXPECT_EQ(i + 0.5f, h1.get(i));
+	}
+}
+
+TEST_F(TestHashTable, MethodFind)
+{
+	h1.put(1, 1.5f);
+
+	ASSERT_NE(nullptr, h1.find(1));
+	EXPECT_EQ(1.5f, *h1.find(1));
+	EXPECT_EQ(nullptr, h1.find(11));
+	EXPECT_TRUE(h1.contains(1));
+	EXPECT_FALSE(h1.contains(2));
+}
+
+TEST_F(TestHashTable, MethodErase)
+{
+	for (int i = 0; i < 30; ++i)
+	{
+		h1.put(i, i + 0.5f);
+	}
+
+	EXPECT_TRUE(h1.erase(10));
+	EXPECT_FALSE(h1.erase(10));
+	EXPECT_FALSE(h1.contains(10));
+	EXPECT_EQ(29, h1.size());
+	EXPECT_EQ(0.5f, h1.get(0));
+	EXPECT_EQ(20.5f, h1.get(20));
+}
+
+TEST_F(TestHashTable, MethodExportImport)
+{
+	for (int i = 0; i < 100; ++i)
+	{
+		h1.put(i, i + 0.5f);
+	}
+
+	vector<int> keys(h1.size());
+	vector<float> values(h1.size());
+
+	EXPECT_EQ(100, h1.exportTo(keys.data(), values.data()));
+
+	HashTable<int, float> h2(10);
+	h2.put(5, 0.0f);
+	h2.importFrom(keys.data(), values.data(), keys.size());
+
+	EXPECT_EQ(100, h2.size());
+	EXPECT_LE(100, h2.bucketCount());
+
+	for (int i = 0; i < 100; ++i)
+	{
+		ASSERT_EQ(i + 0.5f, h2.get(i));
+	}
+}
+
+TEST_F(TestHashTable, MethodImportParallel)
+{
+	// Enough entries for four threads, with every key twice: the
+	// later value must win.
+	size_t n = 1 << 17;
+	vector<int> keys(2 * n);
+	vector<int> values(2 * n);
+
+	for (size_t i = 0; i < 2 * n; ++i)
+	{
+		keys[i] = static_cast<int>(i % n);
+		values[i] = static_cast<int>(i);
+	}
+
+	HashTable<int, int> h(16);
+	h.importFrom(keys.data(), values.data(), keys.size(), 4);
+
+	EXPECT_EQ(n, h.size());
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		ASSERT_EQ(static_cast<int>(i + n), h.get(static_cast<int>(i)));
+	}
+}
+
+TEST_F(TestHashTable, MethodRehash)
+{
+	for (int i = 0; i < 100; ++i)
+	{
+		h1.put(i, i + 0.5f);
+	}
+
+	EXPECT_EQ(100, h1.size());
+	EXPECT_EQ(10.0, h1.stats().loadFactor);
+
+	h1.rehash(200);
+
+	EXPECT_EQ(100, h1.size());
+	EXPECT_EQ(200, h1.bucketCount());
+	EXPECT_EQ(0.5, h1.stats().loadFactor);
+
+	for (int i = 0; i < 100; ++i)
+	{
+		EXPECT_EQ(i + 0.5f, h1.get(i));
+	}
+}
+
+TEST_F(TestHashTable, MethodStats)
+{
+	for (int i = 0; i < 25; ++i)
+	{
+		h1.put(i, 0.0f);
+	}
+
+	HashTableStats s = h1.stats();
+
+	EXPECT_EQ(10, s.buckets);
+	EXPECT_EQ(25, s.entries);
+	EXPECT_EQ(2.5, s.loadFactor);
+
+	// 5 buckets with 3 entries, 5 with 2.
+	ASSERT_EQ(4, s.chainLengths.size());
+	EXPECT_EQ(5, s.chainLengths[2]);
+	EXPECT_EQ(5, s.chainLengths[3]);
+	EXPECT_LT(0, s.bytesAllocated);
+}
@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "DaryHeap.h"
+#include "IndexedHeap.h"
+#include "PairingHeap.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+class TestHeap : public ::testing::Test
+{
+protected:
+
+	vector<int> randomValues(size_t n, unsigned seed)
+	{
+		mt19937 gen(seed);
+		uniform_int_distribution<int> value(0, 1000);
+		vector<int> v(n);
+
+		for (auto& x : v)
+		{
+			x = value(gen);
+		}
+
+		return v;
+	}
+
+	template<typename Heap>
+	static vector<int> drain(Heap& h)
+	{
+		vector<int> v;
+
+		while (!h.empty())
+		{
+			v.push_back(h.top());
+			h.pop();
+		}
+
+		return v;
+	}
+};
+
+TEST_F(TestHeap, MethodDaryHeap)
+{
+	vector<int> v = randomValues(5000, 1);
+	vector<int> expected = v;
+	sort(expected.begin(), expected.end());
+
+	DaryHeap<int, 4> four;
+	DaryHeap<int, 8> eight;
+
+	for (int x : v)
+	{
+		four.push(x);
+		eight.push(x);
+	}
+
+	EXPECT_EQ(5000, four.size());
+	EXPECT_EQ(expected, drain(four));
+	EXPECT_EQ(expected, drain(eight));
+
+	// Bulk, and largest first.
+	DaryHeap<int, 2, greater<int>> bulk(v.begin(), v.end());
+	reverse(expected.begin(), expected.end());
+
+	EXPECT_EQ(expected, drain(bulk));
+
+	// Pops interleaved with pushes, against a sorted reference.
+	DaryHeap<int, 8> h;
+	vector<int> ref;
+
+	for (size_t i = 0; i < v.size(); ++i)
+	{
+		h.push(v[i]);
+		ref.push_back(v[i]);
+
+		if (i % 3 == 2)
+		{
+			auto it = min_element(ref.begin(), ref.end());
+			ASSERT_EQ(*it, h.top());
+			ref.erase(it);
+			h.pop();
+		}
+	}
+
+	h.pushAll(v.begin(), v.begin() + 100);
+	ref.insert(ref.end(), v.begin(), v.begin() + 100);
+	sort(ref.begin(), ref.end());
+
+	EXPECT_EQ(ref, drain(h));
+}
+
+TEST_F(TestHeap, MethodIndexedHeap)
+{
+	vector<int> v = randomValues(3000, 2);
+	IndexedHeap<int, int> h(4);
+	vector<int> priority(v.size());
+
+	for (size_t i = 0; i < v.size(); ++i)
+	{
+		ASSERT_TRUE(h.push(static_cast<int>(i), v[i]));
+		priority[i] = v[i];
+	}
+
+	EXPECT_FALSE(h.push(0, -1));
+	EXPECT_EQ(v[0], h.priority(0));
+
+	mt19937 gen(3);
+	uniform_int_distribution<int> pick(0, static_cast<int>(v.size()) - 1);
+
+	for (int i = 0; i < 2000; ++i)
+	{
+		int key = pick(gen);
+
+		priority[key] -= 50;
+		ASSERT_TRUE(h.decreaseKey(key, priority[key]));
+	}
+
+	for (int key = 0; key < 300; ++key)
+	{
+		ASSERT_TRUE(h.erase(key));
+	}
+
+	EXPECT_FALSE(h.erase(0));
+	EXPECT_FALSE(h.decreaseKey(0, 0));
+	EXPECT_FALSE(h.contains(0));
+	EXPECT_TRUE(h.contains(300));
+
+	vector<pair<int, int>> expected;
+
+	for (size_t key = 300; key < v.size(); ++key)
+	{
+		expected.emplace_back(priority[key], static_cast<int>(key));
+	}
+
+	sort(expected.begin(), expected.end());
+
+	vector<pair<int, int>> popped;
+
+	while (!h.empty())
+	{
+		popped.emplace_back(h.topPriority(), h.topKey());
+		h.pop();
+	}
+
+	// Equal priorities come out in any order.
+	sort(popped.begin(), popped.end());
+	EXPECT_EQ(expected, popped);
+
+	vector<pair<int, int>> items{ { 7, 70 }, { 3, 30 }, { 9, 90 }, { 1, 10 } };
+	IndexedHeap<int, int> bulk(items.begin(), items.end());
+
+	EXPECT_EQ(1, bulk.topKey());
+	EXPECT_TRUE(bulk.decreaseKey(9, 5));
+	EXPECT_EQ(9, bulk.topKey());
+	EXPECT_EQ(5, bulk.topPriority());
+}
+
+TEST_F(TestHeap, MethodPairingHeap)
+{
+	vector<int> v = randomValues(3000, 4);
+	PairingHeap<int> h;
+	vector<PairingHeap<int>::Handle> handles;
+
+	for (int x : v)
+	{
+		handles.push_back(h.push(x));
+	}
+
+	// Handles of popped elements are dead, so lower only those of
+	// elements still in the heap: the first half to go is never touched.
+	vector<int> values = v;
+	vector<int> first;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		first.push_back(h.top());
+		h.pop();
+	}
+
+	vector<int> sortedV = v;
+	sort(sortedV.begin(), sortedV.end());
+	EXPECT_EQ(vector<int>(sortedV.begin(), sortedV.begin() + 100), first);
+
+	int cut = sortedV[100];
+	mt19937 gen(5);
+	uniform_int_distribution<size_t> pick(0, v.size() - 1);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		size_t k = pick(gen);
+
+		if (values[k] > cut)
+		{
+			values[k] -= 10;
+			h.decreaseKey(handles[k], values[k]);
+		}
+	}
+
+	vector<int> rest;
+
+	for (size_t k = 0; k < values.size(); ++k)
+	{
+		if (v[k] > cut)
+			rest.push_back(values[k]);
+	}
+
+	PairingHeap<int> other(v.begin(), v.begin() + 10);
+	rest.insert(rest.end(), v.begin(), v.begin() + 10);
+
+	h.merge(std::move(other));
+
+	// Values <= cut that were not among the first 100 popped.
+	size_t same = count(sortedV.begin() + 100, sortedV.end(), cut);
+	rest.insert(rest.end(), same, cut);
+
+	sort(rest.begin(), rest.end());
+
+	EXPECT_EQ(rest.size(), h.size());
+	EXPECT_EQ(rest, drain(h));
+	EXPECT_TRUE(other.empty());
+}
+
+TEST_F(TestHeap, MethodPairingHeapMove)
+{
+	PairingHeap<int> a;
+	PairingHeap<int>::Handle five = a.push(5);
+	a.push(3);
+
+	PairingHeap<int> b(std::move(a));
+
+	EXPECT_TRUE(a.empty());
+	EXPECT_EQ(0, a.size());
+	EXPECT_EQ(2, b.size());
+
+	// The moved-from heap is empty, not sharing b's nodes.
+	a.push(7);
+	EXPECT_EQ(7, a.top());
+	EXPECT_EQ(3, b.top());
+
+	b.decreaseKey(five, 1);
+
+	PairingHeap<int> c;
+	c = std::move(b);
+
+	EXPECT_TRUE(b.empty());
+	EXPECT_EQ(vector<int>({ 1, 3 }), drain(c));
+}
@@ -0,0 +1,100 @@
+#include <random>
+#include <vector>
+
+#include "Interleaved.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+class TestInterleaved : public ::testing::Test
+{
+protected:
+
+	vector<int> randomKeys(size_t n, unsigned seed)
+	{
+		mt19937 gen(seed);
+		uniform_int_distribution<int> key(0, 20000);
+		vector<int> v(n);
+
+		for (auto& k : v)
+		{
+			k = key(gen);
+		}
+
+		return v;
+	}
+};
+
+TEST_F(TestInterleaved, MethodContains)
+{
+	BinarySearchTree<int> t(randomKeys(5000, 1));
+	vector<int> queries = randomKeys(3000, 2);
+
+	for (size_t width : { 1, 3, 16, 5000 })
+	{
+		vector<int> found(queries.size(), -1);
+
+		Interleaved::interleave(queries.size(), width,
+				[&](size_t i) { return Interleaved::contains(t, queries[i]); },
+				[&](size_t i, bool hit) { found[i] = hit; });
+
+		for (size_t i = 0; i < queries.size(); ++i)
+		{
+			ASSERT_EQ(t.contains(queries[i]), found[i] == 1) << width;
+		}
+	}
+
+	BinarySearchTree<int> empty;
+	bool hit = true;
+
+	Interleaved::interleave(1, 4,
+			[&](size_t) { return Interleaved::contains(empty, 7); },
+			[&](size_t, bool h) { hit = h; });
+
+	EXPECT_FALSE(hit);
+
+	size_t calls = 0;
+
+	Interleaved::interleave(0, 4,
+			[&](size_t) { return Interleaved::contains(t, 7); },
+			[&](size_t, bool) { ++calls; });
+
+	EXPECT_EQ(0, calls);
+
+	// Width 0 runs the lookups one at a time instead of none.
+	Interleaved::interleave(queries.size(), 0,
+			[&](size_t i) { return Interleaved::contains(t, queries[i]); },
+			[&](size_t, bool) { ++calls; });
+
+	EXPECT_EQ(queries.size(), calls);
+}
+
+TEST_F(TestInterleaved, MethodFind)
+{
+	HashTable<int, int> table(512);
+	vector<int> keys = randomKeys(2000, 3);
+
+	for (int k : keys)
+	{
+		table.put(k, k * 2);
+	}
+
+	vector<int> queries = randomKeys(3000, 4);
+	vector<int*> found(queries.size());
+
+	Interleaved::interleave(queries.size(), 8,
+			[&](size_t i) { return Interleaved::find(table, queries[i]); },
+			[&](size_t i, int* value) { found[i] = value; });
+
+	for (size_t i = 0; i < queries.size(); ++i)
+	{
+		ASSERT_EQ(table.find(queries[i]), found[i]);
+	}
+
+	// Values can be written through the results.
+	Interleaved::interleave(1, 8,
+			[&](size_t) { return Interleaved::find(table, keys[0]); },
+			[&](size_t, int* value) { *value = -1; });
+
+	EXPECT_EQ(-1, table.get(keys[0]));
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "IntervalTree.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+// Subtree sizes: the simplest augmentation.
+struct Count
+{
+	typedef size_t value_type;
+
+	static size_t summarize(const int&, const size_t* left, const size_t* right)
+	{
+		return 1 + (left ? *left : 0) + (right ? *right : 0);
+	}
+};
+
+template<typename E>
+static bool summariesHold(const Node<E>* node)
+{
+	if (!node)
+		return true;
+
+	size_t count = 1 + (node->left ? node->left->data.summary : 0) + (node->right ? node->right->data.summary : 0);
+
+	return node->data.summary == count && summariesHold(node->left) && summariesHold(node->right);
+}
+
+class TestIntervalTree : public ::testing::Test
+{
+protected:
+
+	vector<Interval<int>> randomIntervals(size_t n)
+	{
+		mt19937 gen(7);
+		uniform_int_distribution<int> start(0, 10000);
+		uniform_int_distribution<int> length(0, 200);
+		vector<Interval<int>> v;
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			int lo = start(gen);
+			v.push_back(Interval<int>{ lo, lo + length(gen) });
+		}
+
+		return v;
+	}
+
+	static vector<Interval<int>> scan(const vector<Interval<int>>& v, int lo, int hi)
+	{
+		vector<Interval<int>> out;
+
+		for (const auto& i : v)
+		{
+			if (i.overlaps(lo, hi))
+				out.push_back(i);
+		}
+
+		sort(out.begin(), out.end());
+
+		return out;
+	}
+};
+
+TEST_F(TestIntervalTree, MethodAugmentedTree)
+{
+	AugmentedTree<int, Count> t;
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		t.insert(i);
+	}
+
+	for (int i = 0; i < 1000; i += 2)
+	{
+		ASSERT_TRUE(t.erase(i));
+	}
+
+	EXPECT_FALSE(t.erase(0));
+	EXPECT_EQ(500, t.size());
+	EXPECT_EQ(500, t.root()->data.summary);
+	EXPECT_TRUE(summariesHold(t.root()));
+
+	// Sorted inserts would make a plain BST a list.
+	EXPECT_GT(40, t.height());
+
+	vector<int> keys{ 5, 3, 9, 1 };
+	AugmentedTree<int, Count> bulk(keys.begin(), keys.end());
+
+	EXPECT_EQ(3, bulk.height());
+	EXPECT_TRUE(summariesHold(bulk.root()));
+
+	bulk.insert(4);
+
+	EXPECT_EQ(5, bulk.root()->data.summary);
+	EXPECT_TRUE(summariesHold(bulk.root()));
+
+	AugmentedTree<int, Count> moved(std::move(bulk));
+
+	EXPECT_EQ(5, moved.size());
+	EXPECT_EQ(0, bulk.size());
+	EXPECT_EQ(nullptr, bulk.root());
+
+	t = std::move(moved);
+
+	EXPECT_EQ(5, t.size());
+	EXPECT_EQ(0, moved.size());
+	EXPECT_EQ(nullptr, moved.root());
+	EXPECT_FALSE(moved.erase(5));
+}
+
+TEST_F(TestIntervalTree, MethodOverlap)
+{
+	vector<Interval<int>> v = randomIntervals(2000);
+	IntervalTree<int> bulk(v.begin(), v.end());
+	IntervalTree<int> t;
+
+	for (const auto& i : v)
+	{
+		t.insert(i.lo, i.hi);
+	}
+
+	EXPECT_EQ(2000, t.size());
+
+	for (int lo = -100; lo < 10300; lo += 97)
+	{
+		vector<Interval<int>> expected = scan(v, lo, lo + 50);
+		vector<Interval<int>> found = t.overlapping(lo, lo + 50);
+		vector<Interval<int>> foundBulk = bulk.overlapping(lo, lo + 50);
+
+		sort(found.begin(), found.end());
+		sort(foundBulk.begin(), foundBulk.end());
+
+		ASSERT_EQ(expected, found);
+		ASSERT_EQ(expected, foundBulk);
+	}
+}
+
+TEST_F(TestIntervalTree, MethodStab)
+{
+	IntervalTree<int> t;
+
+	t.insert(1, 5);
+	t.insert(3, 8);
+	t.insert(10, 12);
+	t.insert(5, 5);
+
+	vector<Interval<int>> found;
+	t.stab(5, [&found](const Interval<int>& i) { found.push_back(i); });
+	sort(found.begin(), found.end());
+
+	EXPECT_EQ((vector<Interval<int>>{ { 1, 5 }, { 3, 8 }, { 5, 5 } }), found);
+	EXPECT_TRUE(t.overlapping(9, 9).empty());
+
+	EXPECT_TRUE(t.erase(3, 8));
+	EXPECT_FALSE(t.erase(3, 8));
+	EXPECT_EQ(2, t.overlapping(5, 5).size());
+}
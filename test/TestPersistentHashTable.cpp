@@ -0,0 +1,139 @@
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "PersistentHashTable.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+typedef PersistentHashTable<int, double> Table;
+
+class TestPersistentHashTable : public ::testing::Test
+{
+protected:
+
+	TestPersistentHashTable()
+		: path(::testing::TempDir() + "TestPersistentHashTable.tbl")
+	{
+		remove();
+	}
+
+	~TestPersistentHashTable()
+	{
+		remove();
+	}
+
+	void remove()
+	{
+		std::remove(path.c_str());
+		std::remove((path + ".log").c_str());
+		std::remove((path + ".tmp").c_str());
+	}
+
+	string path;
+};
+
+TEST_F(TestPersistentHashTable, MethodBuildOpen)
+{
+	vector<pair<int, double>> v;
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		v.push_back(make_pair(i * 3, i + 0.5));
+	}
+
+	Table::build(path, v.begin(), v.end(), v.size());
+
+	// Two readers share the file.
+	Table r1(path);
+	Table r2(path);
+
+	EXPECT_EQ(1000, r1.size());
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		EXPECT_EQ(i + 0.5, r1.get(i * 3));
+		EXPECT_TRUE(r2.contains(i * 3));
+		EXPECT_FALSE(r2.contains(i * 3 + 1));
+	}
+
+	EXPECT_THROW(r1.put(1, 1.0), std::logic_error);
+}
+
+TEST_F(TestPersistentHashTable, MethodReplayLog)
+{
+	{
+		Table t(path, Table::ReadWrite);
+
+		t.put(1, 1.5);
+		t.put(2, 2.5);
+		t.put(1, 3.5);
+		t.sync();
+
+		EXPECT_EQ(2, t.size());
+		EXPECT_EQ(3.5, t.get(1));
+
+		// Only one writer at a time.
+		EXPECT_THROW(Table(path, Table::ReadWrite), std::runtime_error);
+	}
+
+	// Not checkpointed: readers see the empty table.
+	EXPECT_EQ(0, Table(path).size());
+
+	// A torn record at the end of the log, as left by a crash.
+	int fd = ::open((path + ".log").c_str(), O_WRONLY | O_APPEND);
+	ASSERT_LE(0, fd);
+	ASSERT_EQ(5, ::write(fd, "junk!", 5));
+	::close(fd);
+
+	Table t(path, Table::ReadWrite);
+
+	EXPECT_EQ(2, t.size());
+	EXPECT_EQ(3.5, t.get(1));
+	EXPECT_EQ(2.5, t.get(2));
+
+	t.checkpoint();
+
+	Table r(path);
+
+	EXPECT_EQ(2, r.size());
+	EXPECT_EQ(3.5, r.get(1));
+	EXPECT_EQ(2.5, r.get(2));
+}
+
+TEST_F(TestPersistentHashTable, MethodCheckpointGrow)
+{
+	Table t(path, Table::ReadWrite);
+	size_t capacity = t.capacity();
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		t.put(i, i * 2.0);
+	}
+
+	t.checkpoint();
+
+	EXPECT_LT(capacity, t.capacity());
+	EXPECT_EQ(1000, t.size());
+
+	for (int i = 0; i < 1000; i += 2)
+	{
+		t.put(i, -1.0);
+	}
+
+	t.checkpoint();
+
+	Table r(path);
+
+	EXPECT_EQ(1000, r.size());
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		EXPECT_EQ(i % 2 ? i * 2.0 : -1.0, r.get(i));
+	}
+}
@@ -0,0 +1,98 @@
+#include "RobinHoodHashTable.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+class TestRobinHoodHashTable : public ::testing::Test
+{
+protected:
+
+	RobinHoodHashTable<int, float> h1;
+};
+
+TEST_F(TestRobinHoodHashTable, MethodPutGet)
+{
+	h1.put(1, 1.1f);
+	h1.put(2, 2.2f);
+
+	EXPECT_EQ(1.1f, h1.get(1));
+	EXPECT_EQ(2.2f, h1.get(2));
+
+	h1.put(2, 3.3f);
+
+	EXPECT_EQ(3.3f, h1.get(2));
+	EXPECT_EQ(2, h1.size());
+	EXPECT_FALSE(h1.contains(3));
+	EXPECT_EQ(nullptr, h1.find(3));
+}
+
+TEST_F(TestRobinHoodHashTable, MethodLoad)
+{
+	RobinHoodHashTable<int, int> h(900);
+
+	EXPECT_EQ(1024, h.bucketCount());
+
+	for (int i = 0; i < 900; ++i)
+	{
+		h.put(i * 64, i);
+	}
+
+	// Up to 90% without a resize.
+	EXPECT_EQ(1024, h.bucketCount());
+
+	for (int i = 0; i < 900; ++i)
+	{
+		ASSERT_EQ(i, h.get(i * 64));
+	}
+}
+
+TEST_F(TestRobinHoodHashTable, MethodErase)
+{
+	for (int i = 0; i < 100; ++i)
+	{
+		h1.put(i, i + 0.5f);
+	}
+
+	for (int i = 0; i < 100; i += 2)
+	{
+		EXPECT_TRUE(h1.erase(i));
+	}
+
+	EXPECT_FALSE(h1.erase(0));
+	EXPECT_EQ(50, h1.size());
+
+	for (int i = 0; i < 100; ++i)
+	{
+		ASSERT_EQ(i % 2 == 1, h1.contains(i));
+	}
+}
+
+TEST_F(TestRobinHoodHashTable, MethodChurn)
+{
+	// A sliding window of keys: the probe distances must not creep up
+	// the way tombstones would make them.
+	RobinHoodHashTable<int, int> h(1000);
+
+	for (int i = 0; i < 900; ++i)
+	{
+		h.put(i, i);
+	}
+
+	size_t slots = h.bucketCount();
+	size_t before = h.stats().chainLengths.size();
+
+	for (int i = 900; i < 100000; ++i)
+	{
+		h.erase(i - 900);
+		h.put(i, i);
+	}
+
+	EXPECT_EQ(900, h.size());
+	EXPECT_EQ(slots, h.bucketCount());
+	EXPECT_GE(before + 8, h.stats().chainLengths.size());
+
+	for (int i = 100000 - 900; i < 100000; ++i)
+	{
+		ASSERT_EQ(i, h.get(i));
+	}
+}
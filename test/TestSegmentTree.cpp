@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "SegmentTree.h"
+#include "FenwickTree.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+class TestSegmentTree : public ::testing::Test
+{
+protected:
+
+	vector<long> values{ 5, -2, 7, 3, 0, 9, -4, 1, 6, 2, 8 };
+};
+
+TEST_F(TestSegmentTree, MethodQuery)
+{
+	SegmentTree<long> sum(values.begin(), values.end());
+	SegmentTree<long, MinOp<long>> min(values.begin(), values.end());
+	SegmentTree<long, MaxOp<long>> max(values.begin(), values.end());
+
+	EXPECT_EQ(values.size(), sum.size());
+	EXPECT_EQ(35, sum.query(0, values.size()));
+	EXPECT_EQ(8, sum.query(1, 4));
+	EXPECT_EQ(-4, min.query(0, 100));
+	EXPECT_EQ(0, min.query(3, 5));
+	EXPECT_EQ(9, max.query(2, 7));
+	EXPECT_EQ(0, sum.query(4, 4));
+	EXPECT_EQ(numeric_limits<long>::max(), min.query(4, 4));
+
+	sum.set(5, 1);
+	max.set(5, 1);
+
+	EXPECT_EQ(27, sum.query(0, values.size()));
+	EXPECT_EQ(7, max.query(2, 7));
+	EXPECT_EQ(1, sum.get(5));
+
+	// Past the end: set is ignored, get gives the identity.
+	sum.set(values.size(), 100);
+	sum.set(1000, 100);
+
+	EXPECT_EQ(27, sum.query(0, 1000));
+	EXPECT_EQ(0, sum.get(values.size()));
+	EXPECT_EQ(numeric_limits<long>::max(), min.get(1000));
+
+	// Queries on a const tree see the adds still pending.
+	sum.add(0, 4, 10);
+
+	const SegmentTree<long>& view = sum;
+
+	EXPECT_EQ(15, view.get(0));
+	EXPECT_EQ(38, view.query(1, 4));
+}
+
+TEST_F(TestSegmentTree, MethodRangeAdd)
+{
+	// Random adds, sets and queries against a plain array.
+	SegmentTree<long> sum(values.begin(), values.end());
+	SegmentTree<long, MinOp<long>> min(values.begin(), values.end());
+	vector<long> v(values);
+	mt19937 gen(3);
+
+	for (int round = 0; round < 2000; ++round)
+	{
+		size_t a = gen() % (v.size() + 1);
+		size_t b = gen() % (v.size() + 1);
+		size_t first = std::min(a, b);
+		size_t last = std::max(a, b);
+		long delta = static_cast<long>(gen() % 21) - 10;
+
+		switch (gen() % 3)
+		{
+		case 0:
+			sum.add(first, last, delta);
+			min.add(first, last, delta);
+
+			for (size_t i = first; i < last; ++i)
+			{
+				v[i] += delta;
+			}
+			break;
+
+		case 1:
+			if (first < v.size())
+			{
+				sum.set(first, delta);
+				min.set(first, delta);
+				v[first] = delta;
+			}
+			break;
+
+		default:
+			ASSERT_EQ(accumulate(v.begin() + first, v.begin() + last, 0L), sum.query(first, last));
+
+			if (first < last)
+			{
+				ASSERT_EQ(*min_element(v.begin() + first, v.begin() + last), min.query(first, last));
+			}
+		}
+	}
+}
+
+TEST_F(TestSegmentTree, MethodFenwick)
+{
+	FenwickTree<long> f(values.begin(), values.end());
+	FenwickTree<long> g(values.size());
+
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		g.add(i, values[i]);
+	}
+
+	for (size_t n = 0; n <= values.size(); ++n)
+	{
+		long expected = accumulate(values.begin(), values.begin() + n, 0L);
+
+		ASSERT_EQ(expected, f.prefix(n));
+		ASSERT_EQ(expected, g.prefix(n));
+	}
+
+	f.add(3, 10);
+
+	EXPECT_EQ(18, f.sum(1, 4));
+	EXPECT_EQ(0, f.sum(4, 4));
+	EXPECT_EQ(values.size(), f.size());
+}
@@ -0,0 +1,69 @@
+// Counters only exist when DS_STATS is defined.
+#define DS_STATS
+
+#include <sstream>
+
+#include "HashTable.h"
+#include "BinarySearchTree.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+TEST(TestStats, HashTableCounters)
+{
+	HashTable<int, int> h(10);
+
+	h.put(1, 1);
+	h.put(11, 11);
+	h.put(21, 21);
+
+	// Third entry of the chain.
+	h.get(21);
+
+	HashTableStats s = h.stats();
+
+	EXPECT_EQ(4, s.lookups);
+	EXPECT_EQ(0 + 1 + 2 + 3, s.probes);
+	EXPECT_EQ(3, s.maxProbe);
+	EXPECT_EQ(0, s.resizes);
+
+	h.rehash(20);
+
+	EXPECT_EQ(1, h.stats().resizes);
+
+	stringstream ss;
+	h.stats().dump(ss);
+
+	EXPECT_NE(string::npos, ss.str().find("resizes: 1"));
+}
+
+TEST(TestStats, TreeCounters)
+{
+	BinarySearchTree<int> t{ 50, 25, 15, 35, 1, 40, 80, 55, 95 };
+
+	EXPECT_TRUE(t.contains(50));
+	EXPECT_TRUE(t.contains(1));
+	EXPECT_FALSE(t.contains(2));
+
+	TreeStats s = t.stats();
+
+	EXPECT_EQ(9, s.nodes);
+	EXPECT_EQ(4, s.height);
+	EXPECT_EQ(9, s.allocations);
+	EXPECT_EQ(0, s.frees);
+	EXPECT_EQ(3, s.searches);
+
+	// 50 at depth 1, 1 and the miss of 2 at depth 4.
+	ASSERT_EQ(5, s.searchDepths.size());
+	EXPECT_EQ(1, s.searchDepths[1]);
+	EXPECT_EQ(2, s.searchDepths[4]);
+
+	stringstream in("10 5 20");
+	t.deserialize(in);
+
+	s = t.stats();
+
+	EXPECT_EQ(3, s.nodes);
+	EXPECT_EQ(12, s.allocations);
+	EXPECT_EQ(9, s.frees);
+}